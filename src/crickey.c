@@ -12,7 +12,7 @@
  	 	 	 	 	 check out the references section specially.
  	 	 	 	 >> handbook/reference for current CRC algos: http://reveng.sourceforge.net/crc-catalogue/ (Greg Cook)
  	 	 	 	 Thanks to these guys, I finally have a working and clearly understood crc implementation.
- 	 	 	 	 the goal is to target any crc-8/crc-16/crc-32 algorithms out there, leaving out the exotic crc widths (12/24/31...)
+ 	 	 	 	 the goal is to target any crc-8/crc-16/crc-32/crc-64 algorithms out there, leaving out the exotic crc widths (12/24/31...)
  	 	 	 	 and to ensure that all the common options can be changed on the go, to keep it flexible.
  	 	 	 	 this is all public domain code, so enjoy.
  ============================================================================
@@ -20,9 +20,74 @@
 
 
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE				// SEEK_DATA / SEEK_HOLE from unistd.h on glibc, see crc_manifest_read_range().
+#endif // _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+
+///////////////////////////////////////////////////////////////////		SLICING DEFINES ++	///////////////////////////////////////////////////////////////////
+#define CRC_SLICES_4			(4)
+#define CRC_SLICES_8			(8)
+#define CRC_SLICES_16			(16)
+#define CRC_SLICES_MAX			CRC_SLICES_16
+///////////////////////////////////////////////////////////////////		SLICING DEFINES --	///////////////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////		CLMUL DEFINES ++	///////////////////////////////////////////////////////////////////
+// carry-less multiply (PCLMULQDQ) folding, for any 16/32 bit polynomial. the data is folded 64 bytes per iteration into
+// four 128 bit accumulators, those are folded into one, and the last 128 bits are reduced to the crc with a barrett reduction.
+// every width runs as a 32 bit crc on the polynomial shifted up to the top (P * x^(32-width)), which just moves the register
+// up by the same amount, so one engine and one set of fold constants per (polynomial, direction) covers all widths.
+// the engine is picked at runtime by cpuid, and the byte table is the fallback as well as the tail handler.
+#if defined(__GNUC__) && defined(__x86_64__)
+#define USE_CLMUL_FOR_CRC
+#include <immintrin.h>
+#endif // __GNUC__ && __x86_64__
+
+#ifdef USE_CLMUL_FOR_CRC
+// below this the fold setup and reduction cost more than they save over the table.
+#define CRC_CLMUL_MIN_LEN				(64)
+
+// all constants are remainders mod P' = x^32 + (polynomial << (32-width)), stored as the engine consumes them:
+// as is for the normal direction, bit-reversed (and pre-shifted for the reflected product, see generate_crc_clmul_constants()) otherwise.
+typedef struct
+{
+	uint64_t fold_by_4 [2];		// {x^512, x^576} mod P', 4 accumulators 512 bits apart.
+	uint64_t fold_by_1 [2];		// {x^128, x^192} mod P', one accumulator onto the next 128 bits.
+	uint64_t reduce_96;			// x^96 mod P', 128 -> 96 bits.
+	uint64_t reduce_64;			// x^64 mod P', 96 -> 64 bits.
+	uint64_t barrett_mu;		// floor(x^64 / P'), 33 bits.
+	uint64_t barrett_poly;		// P' itself, 33 bits.
+	uint8_t width;
+	uint8_t reflected;
+} crc_clmul_constants_t;
+
+// the 64 bit version: P = x^64 + polynomial doesn't fit the 32 bit engine, so it has its own fold and reduction constants.
+// folding works the same, the last 128 bits are multiplied on by x^64 and reduced with a 64 bit barrett reduction.
+typedef struct
+{
+	uint64_t fold_by_4 [2];		// {x^512, x^576} mod P.
+	uint64_t fold_by_1 [2];		// {x^128, x^192} mod P.
+	uint64_t reduce_128;		// x^128 mod P, 128 -> 64 + 64 bits.
+	uint64_t barrett_mu;		// floor(x^128 / P) without its x^64 term.
+	uint64_t barrett_poly;		// P without its x^64 term.
+	uint8_t reflected;
+} crc_clmul64_constants_t;
+#endif // #ifdef USE_CLMUL_FOR_CRC
+///////////////////////////////////////////////////////////////////		CLMUL DEFINES --	///////////////////////////////////////////////////////////////////
+
 
 
 ///////////////////////////////////////////////////////////////////		CRC8 DEFINES ++	///////////////////////////////////////////////////////////////////
@@ -31,7 +96,18 @@
 
 #ifdef USE_TABLE_FOR_CRC_8
 uint8_t crc8_table [256] = {0};
+uint8_t crc8_table_reflected [256] = {0};
 #endif // #define USE_TABLE_FOR_CRC_8
+
+// half-byte engine: a 16 entry table per direction (16 bytes), two lookups per byte. the middle ground between the
+// byte table and the bitwise loop for targets the 256 entry table doesn't fit, and what calculate_crc8() and the model
+// engines fall back to without USE_TABLE_FOR_CRC_8.
+#define USE_NIBBLE_TABLE_FOR_CRC_8
+
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_8
+uint8_t crc8_nibble_table [16] = {0};
+uint8_t crc8_nibble_table_reflected [16] = {0};
+#endif // #ifdef USE_NIBBLE_TABLE_FOR_CRC_8
 ///////////////////////////////////////////////////////////////////		CRC8 DEFINES --	///////////////////////////////////////////////////////////////////
 
 
@@ -42,7 +118,40 @@ uint8_t crc8_table [256] = {0};
 
 #ifdef USE_TABLE_FOR_CRC_16
 uint16_t crc16_table [256] = {0};
+uint16_t crc16_table_reflected [256] = {0};
 #endif // #ifdef USE_TABLE_FOR_CRC_16
+
+// half-byte engine: a 16 entry table per direction (32 bytes), two lookups per byte. the middle ground between the
+// byte table and the bitwise loop for targets the 256 entry table doesn't fit, and what calculate_crc16() and the model
+// engines fall back to without USE_TABLE_FOR_CRC_16.
+#define USE_NIBBLE_TABLE_FOR_CRC_16
+
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+uint16_t crc16_nibble_table [16] = {0};
+uint16_t crc16_nibble_table_reflected [16] = {0};
+#endif // #ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+
+// slicing-by-N: N derived tables, so that the update consumes 4, 8 or 16 bytes per iteration instead of 1.
+// table[0] is the plain byte table, table[k] is the crc of a byte followed by k zero bytes.
+#define USE_SLICING_FOR_CRC_16
+
+#ifdef USE_SLICING_FOR_CRC_16
+#ifndef USE_TABLE_FOR_CRC_16
+#error "USE_SLICING_FOR_CRC_16 needs USE_TABLE_FOR_CRC_16"
+#endif // #ifndef USE_TABLE_FOR_CRC_16
+uint16_t crc16_slicing_table [CRC_SLICES_MAX][256] = {{0}};
+uint16_t crc16_slicing_table_reflected [CRC_SLICES_MAX][256] = {{0}};
+#endif // #ifdef USE_SLICING_FOR_CRC_16
+
+// PCLMULQDQ folding for the bulk of the data, constants are generated along with the table.
+#if defined(USE_CLMUL_FOR_CRC) && defined(USE_TABLE_FOR_CRC_16)
+#define USE_CLMUL_FOR_CRC_16
+#endif // USE_CLMUL_FOR_CRC && USE_TABLE_FOR_CRC_16
+
+#ifdef USE_CLMUL_FOR_CRC_16
+crc_clmul_constants_t crc16_clmul_constants;
+crc_clmul_constants_t crc16_clmul_constants_reflected;
+#endif // #ifdef USE_CLMUL_FOR_CRC_16
 ///////////////////////////////////////////////////////////////////		CRC16 DEFINES --	///////////////////////////////////////////////////////////////////
 
 
@@ -53,53 +162,1077 @@ uint16_t crc16_table [256] = {0};
 
 #ifdef USE_TABLE_FOR_CRC_32
 uint32_t crc32_table [256] = {0};
+uint32_t crc32_table_reflected [256] = {0};
 #endif // #ifdef USE_TABLE_FOR_CRC_32
+
+// half-byte engine: a 16 entry table per direction (64 bytes), two lookups per byte. the middle ground between the
+// byte table and the bitwise loop for targets the 256 entry table doesn't fit, and what calculate_crc32() and the model
+// engines fall back to without USE_TABLE_FOR_CRC_32.
+#define USE_NIBBLE_TABLE_FOR_CRC_32
+
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+uint32_t crc32_nibble_table [16] = {0};
+uint32_t crc32_nibble_table_reflected [16] = {0};
+#endif // #ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+
+// slicing-by-N: N derived tables, so that the update consumes 4, 8 or 16 bytes per iteration instead of 1.
+// table[0] is the plain byte table, table[k] is the crc of a byte followed by k zero bytes.
+#define USE_SLICING_FOR_CRC_32
+
+#ifdef USE_SLICING_FOR_CRC_32
+#ifndef USE_TABLE_FOR_CRC_32
+#error "USE_SLICING_FOR_CRC_32 needs USE_TABLE_FOR_CRC_32"
+#endif // #ifndef USE_TABLE_FOR_CRC_32
+uint32_t crc32_slicing_table [CRC_SLICES_MAX][256] = {{0}};
+uint32_t crc32_slicing_table_reflected [CRC_SLICES_MAX][256] = {{0}};
+#endif // #ifdef USE_SLICING_FOR_CRC_32
+
+// PCLMULQDQ folding for the bulk of the data, constants are generated along with the table.
+#if defined(USE_CLMUL_FOR_CRC) && defined(USE_TABLE_FOR_CRC_32)
+#define USE_CLMUL_FOR_CRC_32
+#endif // USE_CLMUL_FOR_CRC && USE_TABLE_FOR_CRC_32
+
+#ifdef USE_CLMUL_FOR_CRC_32
+crc_clmul_constants_t crc32_clmul_constants;
+crc_clmul_constants_t crc32_clmul_constants_reflected;
+#endif // #ifdef USE_CLMUL_FOR_CRC_32
+
+// CRC-32C (castagnoli) has its own instruction since SSE4.2, picked at runtime by cpuid when the cpu has it.
+// the instruction has a latency of 3 cycles but a throughput of 1, so 3 independent streams are run over 3 adjacent
+// blocks, and merged at the end by shifting the earlier block crcs over the later blocks (carry-less multiply, PCLMULQDQ).
+#if defined(__GNUC__) && defined(__x86_64__)
+#define USE_HW_FOR_CRC_32C
+#endif // __GNUC__ && __x86_64__
+
+#ifdef USE_HW_FOR_CRC_32C
+#define CRC_32C_POLYNOMIAL				(0x1EDC6F41)
+#define CRC_32C_HW_LONG_BLOCK			(8192)
+#define CRC_32C_HW_SHORT_BLOCK			(256)
+// x^(8*block-33) mod P, reflected: shift constants for the block sizes above, see shift_crc32c_hw().
+#define CRC_32C_HW_LONG_SHIFT			(0x54A86326)
+#define CRC_32C_HW_SHORT_SHIFT			(0xB9E02B86)
+#endif // #ifdef USE_HW_FOR_CRC_32C
 ///////////////////////////////////////////////////////////////////		CRC32 DEFINES --	///////////////////////////////////////////////////////////////////
 
 
 
+///////////////////////////////////////////////////////////////////		CRC64 DEFINES ++	///////////////////////////////////////////////////////////////////
+#define ENABLE_CRC_64
+#define USE_TABLE_FOR_CRC_64
+
+#ifdef USE_TABLE_FOR_CRC_64
+uint64_t crc64_table [256] = {0};
+uint64_t crc64_table_reflected [256] = {0};
+#endif // #ifdef USE_TABLE_FOR_CRC_64
+
+// half-byte engine: a 16 entry table per direction (128 bytes), two lookups per byte. the middle ground between the
+// byte table and the bitwise loop for targets the 256 entry table doesn't fit, and what calculate_crc64() and the model
+// engines fall back to without USE_TABLE_FOR_CRC_64.
+#define USE_NIBBLE_TABLE_FOR_CRC_64
+
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_64
+uint64_t crc64_nibble_table [16] = {0};
+uint64_t crc64_nibble_table_reflected [16] = {0};
+#endif // #ifdef USE_NIBBLE_TABLE_FOR_CRC_64
+
+// slicing-by-8 only: with 64 bit entries 8 slices are already 16KB per direction, and one block fills the whole register.
+#define USE_SLICING_FOR_CRC_64
+
+#ifdef USE_SLICING_FOR_CRC_64
+#ifndef USE_TABLE_FOR_CRC_64
+#error "USE_SLICING_FOR_CRC_64 needs USE_TABLE_FOR_CRC_64"
+#endif // #ifndef USE_TABLE_FOR_CRC_64
+uint64_t crc64_slicing_table [CRC_SLICES_8][256] = {{0}};
+uint64_t crc64_slicing_table_reflected [CRC_SLICES_8][256] = {{0}};
+#endif // #ifdef USE_SLICING_FOR_CRC_64
+
+#if defined(USE_CLMUL_FOR_CRC) && defined(USE_TABLE_FOR_CRC_64)
+#define USE_CLMUL_FOR_CRC_64
+#endif // USE_CLMUL_FOR_CRC && USE_TABLE_FOR_CRC_64
+
+#ifdef USE_CLMUL_FOR_CRC_64
+crc_clmul64_constants_t crc64_clmul_constants;
+crc_clmul64_constants_t crc64_clmul_constants_reflected;
+#endif // #ifdef USE_CLMUL_FOR_CRC_64
+///////////////////////////////////////////////////////////////////		CRC64 DEFINES --	///////////////////////////////////////////////////////////////////
+
+
+
 ///////////////////////////////////////////////////////////////////		COMMON DEFINES ++	///////////////////////////////////////////////////////////////////
-#define TOPBIT(width)	 		(1 << (width-1))
+#define TOPBIT(width)	 		((uint64_t)1 << ((width)-1))
 
 // this portable mask stuff was stolen from: http://www.zlib.net/crc_v3.txt, Ross Williams, avoid for e.g << 32 on a 32-bit machine !!
 // the original, naive stuff is commented below, followed by the magic way to do it right.
 //#define CRC_MASK(width)			((1 << (width)) - 1)
-#define CRC_MASK(width)			((((1L<<(width-1))-1L)<<1)|1L)
+// (uint64_t instead of the original long, which is 32 bits on some of our targets and then can't hold the 64 bit mask.)
+#define CRC_MASK(width)			(((((uint64_t)1<<((width)-1))-1)<<1)|1)
 
 #define CRC_WIDTH_8				(8)
 #define CRC_WIDTH_16			(16)
 #define CRC_WIDTH_32			(32)
+#define CRC_WIDTH_64			(64)
+
 
+#define BITMASK(X) ((uint64_t)1 << (X))
 
-#define BITMASK(X) (1L << (X))
+// for the hot helpers that take a constant (width, direction) and have to fold it away.
+#if defined(__GNUC__)
+#define CRC_FORCE_INLINE		__attribute__((always_inline)) inline
+#else
+#define CRC_FORCE_INLINE		inline
+#endif // __GNUC__
 ///////////////////////////////////////////////////////////////////		COMMON DEFINES --	///////////////////////////////////////////////////////////////////
 
 
 
+///////////////////////////////////////////////////////////////////		MODEL DEFINES ++	///////////////////////////////////////////////////////////////////
+// a crc value or raw register of any supported width.
+typedef uint64_t crc_value_t;
+
+#define CRC_CACHE_LINE_SIZE		(64)
+
+// how many 256 entry tables the registry builds per width: all slices if slicing is on, the byte table if tables are on, else none.
+#if defined(USE_SLICING_FOR_CRC_16)
+#define CRC_TABLE_SLICES_16		CRC_SLICES_MAX
+#elif defined(USE_TABLE_FOR_CRC_16)
+#define CRC_TABLE_SLICES_16		(1)
+#else
+#define CRC_TABLE_SLICES_16		(0)
+#endif // USE_SLICING_FOR_CRC_16
+
+#if defined(USE_SLICING_FOR_CRC_32)
+#define CRC_TABLE_SLICES_32		CRC_SLICES_MAX
+#elif defined(USE_TABLE_FOR_CRC_32)
+#define CRC_TABLE_SLICES_32		(1)
+#else
+#define CRC_TABLE_SLICES_32		(0)
+#endif // USE_SLICING_FOR_CRC_32
+
+#if defined(USE_TABLE_FOR_CRC_8)
+#define CRC_TABLE_SLICES_8		(1)
+#else
+#define CRC_TABLE_SLICES_8		(0)
+#endif // USE_TABLE_FOR_CRC_8
+
+#if defined(USE_SLICING_FOR_CRC_64)
+#define CRC_TABLE_SLICES_64		CRC_SLICES_8
+#elif defined(USE_TABLE_FOR_CRC_64)
+#define CRC_TABLE_SLICES_64		(1)
+#else
+#define CRC_TABLE_SLICES_64		(0)
+#endif // USE_SLICING_FOR_CRC_64
+
+// which widths the registry builds a 16 entry nibble table for, see USE_NIBBLE_TABLE_FOR_CRC_*.
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_8
+#define CRC_NIBBLE_TABLE_8		(1)
+#else
+#define CRC_NIBBLE_TABLE_8		(0)
+#endif // USE_NIBBLE_TABLE_FOR_CRC_8
+
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+#define CRC_NIBBLE_TABLE_16		(1)
+#else
+#define CRC_NIBBLE_TABLE_16		(0)
+#endif // USE_NIBBLE_TABLE_FOR_CRC_16
+
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+#define CRC_NIBBLE_TABLE_32		(1)
+#else
+#define CRC_NIBBLE_TABLE_32		(0)
+#endif // USE_NIBBLE_TABLE_FOR_CRC_32
+
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_64
+#define CRC_NIBBLE_TABLE_64		(1)
+#else
+#define CRC_NIBBLE_TABLE_64		(0)
+#endif // USE_NIBBLE_TABLE_FOR_CRC_64
+
+#if CRC_NIBBLE_TABLE_8 || CRC_NIBBLE_TABLE_16 || CRC_NIBBLE_TABLE_32 || CRC_NIBBLE_TABLE_64
+#define USE_NIBBLE_TABLES
+#endif // CRC_NIBBLE_TABLE_*
+
+// slice count the model engines run below the clmul threshold. 8 keeps the tables of the hot models in L1 next to each other,
+// and short messages are where this matters.
+#define CRC_MODEL_SLICES		CRC_SLICES_8
+
+// tables generated at build time into crickey_tables.h (build crickey.c with -DCRICKEY_GENERATE_TABLES and run it, it
+// prints the header), so the hot models start with their tables already in .rodata, shared between processes
+// through the page cache, and the registry does no table work for them. CRC_CONST_TABLES_MODELS is the list
+// the generator emits, models with the same (width, polynomial, direction) share one table.
+#define USE_CONST_TABLES
+#ifndef CRC_CONST_TABLES_MODELS
+#define CRC_CONST_TABLES_MODELS		{"CRC-8", "CRC-8/DARC", "CRC-16/CCITT-FALSE", "ARC", "CRC-32", "CRC-32/BZIP2", "CRC-32C", "CRC-64/XZ"}
+#endif // CRC_CONST_TABLES_MODELS
+
+#if defined(__GNUC__)
+#define CRC_CONST_TABLE_ALIGNED		__attribute__((aligned(CRC_CACHE_LINE_SIZE)))
+#else
+#define CRC_CONST_TABLE_ALIGNED
+#endif // __GNUC__
+
+// the engines crc_update_register() can run a model on. AUTO is its built-in order (crc32 instruction, clmul folding,
+// slicing, byte table, nibble table, bitwise), the others are one engine each, for the tuner and the benchmark build.
+typedef enum
+{
+	CRC_ENGINE_AUTO,
+	CRC_ENGINE_BITWISE,
+	CRC_ENGINE_NIBBLE,						// 16 entry table, two lookups per byte.
+	CRC_ENGINE_TABLE,
+	CRC_ENGINE_SLICING_4,
+	CRC_ENGINE_SLICING_8,
+	CRC_ENGINE_SLICING_16,
+	CRC_ENGINE_CLMUL,						// the bulk folded, the tail on the byte table.
+	CRC_ENGINE_HW,							// CRC-32C instruction.
+	CRC_ENGINES
+} crc_engine_t;
+
+// engine tuning: crc_tune() times every engine a registry entry can use at each message size class on this cpu and keeps the
+// fastest per class in the entry, crc_update_register() dispatches on that before its built-in order. class k is data_len
+// in [4^k, 4^(k+1)) (the last one open ended), timed at 2 * 4^k bytes. untuned entries keep the built-in order.
+#define USE_ENGINE_TUNING
+#ifdef USE_ENGINE_TUNING
+#define CRC_TUNE_BUCKETS			(9)
+#define CRC_TUNE_MIN_NS				(100 * 1000)				// per timed batch, best of CRC_TUNE_TRIALS.
+#define CRC_TUNE_TRIALS				(3)
+#define CRC_TUNE_CHECK_MAX_LEN		(4096)						// cross-check length cap when loading a tuning file.
+#define CRC_TUNE_FILE_VERSION		(1)
+#define CRC_TUNE_LINE_MAX			(512)
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>							// the cpu brand string that keys a tuning file.
+#endif // __GNUC__ && x86
+#endif // USE_ENGINE_TUNING
+
+typedef struct
+{
+	uint8_t width;
+	crc_value_t polynomial;
+	uint8_t reflected;
+	uint8_t slices;							// only used if it's what the registry would build, see CRC_TABLE_SLICES_*.
+	const void* table_memory;
+} crc_const_tables_t;
+
+// tables for one (width, polynomial, direction), built on first use by the registry and shared by every model that needs them.
+// nothing in here changes after the registry publishes it, so any number of threads can read it without locking. the one
+// exception is tuned_engines, single bytes the tuner stores and the engines load atomically.
+typedef struct crc_tables
+{
+	uint8_t width;
+	crc_value_t polynomial;
+	uint8_t reflected;
+	uint8_t slices;							// number of 256 entry tables, slice 0 is the byte table, see generate_crc32_slicing_tables().
+	union
+	{
+		const void* memory;
+		const uint8_t (*crc8)[256];
+		const uint16_t (*crc16)[256];
+		const uint32_t (*crc32)[256];
+		const uint64_t (*crc64)[256];
+	} slicing;								// cache line aligned.
+#ifdef USE_NIBBLE_TABLES
+	union
+	{
+		uint8_t crc8 [16];
+		uint16_t crc16 [16];
+		uint32_t crc32 [16];
+		uint64_t crc64 [16];
+	} nibble;								// the 16 entry table, if CRC_NIBBLE_TABLE_* is on for the width.
+#endif // USE_NIBBLE_TABLES
+#ifdef USE_CLMUL_FOR_CRC
+	crc_clmul_constants_t clmul;			// 16/32 bit.
+	crc_clmul64_constants_t clmul64;		// 64 bit.
+#endif // USE_CLMUL_FOR_CRC
+	crc_value_t xpow8n_powers [64];			// x^(8*2^k) mod P, natural order: what 2^k zero bytes do to the register, see crc_shift_register().
+#ifdef USE_ENGINE_TUNING
+	uint8_t tuned_engines [CRC_TUNE_BUCKETS];	// crc_engine_t per size class, CRC_ENGINE_AUTO until crc_tune() ran.
+#endif // USE_ENGINE_TUNING
+	struct crc_tables* next;				// registry chain.
+} crc_tables_t;
+
+// one crc model, with the parameters as in the reveng catalogue. the tables are looked up (and built if needed) on first use,
+// so a model is cheap to declare, and any number of models can be used at the same time from any number of threads.
+typedef struct
+{
+	const char* name;
+	uint8_t width;
+	crc_value_t polynomial;
+	crc_value_t initial_value;
+	uint8_t reflect_input;
+	uint8_t reflect_output;
+	crc_value_t final_xor_value;
+	crc_value_t check;						// crc of "123456789".
+	const crc_tables_t* tables;				// NULL until first use, see crc_model_tables().
+} crc_model_t;
+
+// initializer, parameters in catalogue order: CRC_MODEL("CRC-32", 32, 0x04C11DB7, 0xFFFFFFFF, 1, 1, 0xFFFFFFFF, 0xCBF43926)
+#define CRC_MODEL(name, width, polynomial, initial_value, reflect_input, reflect_output, final_xor_value, check) \
+		{ (name), (width), (polynomial), (initial_value), (reflect_input), (reflect_output), (final_xor_value), (check), NULL }
+
+// http://reveng.sourceforge.net/crc-catalogue/, the models this library is checked against.
+crc_model_t crc_catalogue [] =
+{
+	CRC_MODEL("CRC-8",					8,	0x07,		0x00,		0, 0, 0x00,			0xF4),
+	CRC_MODEL("CRC-8/CDMA2000",			8,	0x9B,		0xFF,		0, 0, 0x00,			0xDA),
+	CRC_MODEL("CRC-8/ITU",				8,	0x07,		0x00,		0, 0, 0x55,			0xA1),
+	CRC_MODEL("CRC-8/DARC",				8,	0x39,		0x00,		1, 1, 0x00,			0x15),
+	CRC_MODEL("CRC-8/MAXIM",			8,	0x31,		0x00,		1, 1, 0x00,			0xA1),
+	CRC_MODEL("CRC-8/ROHC",				8,	0x07,		0xFF,		1, 1, 0x00,			0xD0),
+	CRC_MODEL("CRC-16/AUG-CCITT",		16,	0x1021,		0x1D0F,		0, 0, 0x0000,		0xE5CC),
+	CRC_MODEL("CRC-16/CCITT-FALSE",		16,	0x1021,		0xFFFF,		0, 0, 0x0000,		0x29B1),
+	CRC_MODEL("CRC-16/XMODEM",			16,	0x1021,		0x0000,		0, 0, 0x0000,		0x31C3),
+	CRC_MODEL("ARC",					16,	0x8005,		0x0000,		1, 1, 0x0000,		0xBB3D),
+	CRC_MODEL("CRC-16/MODBUS",			16,	0x8005,		0xFFFF,		1, 1, 0x0000,		0x4B37),
+	CRC_MODEL("CRC-16/X-25",			16,	0x1021,		0xFFFF,		1, 1, 0xFFFF,		0x906E),
+	CRC_MODEL("CRC-32",					32,	0x04C11DB7,	0xFFFFFFFF,	1, 1, 0xFFFFFFFF,	0xCBF43926),
+	CRC_MODEL("CRC-32/BZIP2",			32,	0x04C11DB7,	0xFFFFFFFF,	0, 0, 0xFFFFFFFF,	0xFC891918),
+	CRC_MODEL("CRC-32/JAMCRC",			32,	0x04C11DB7,	0xFFFFFFFF,	1, 1, 0x00000000,	0x340BC6D9),
+	CRC_MODEL("CRC-32/MPEG-2",			32,	0x04C11DB7,	0xFFFFFFFF,	0, 0, 0x00000000,	0x0376E6E7),
+	CRC_MODEL("CRC-32/POSIX",			32,	0x04C11DB7,	0x00000000,	0, 0, 0xFFFFFFFF,	0x765E7680),
+	CRC_MODEL("CRC-32C",				32,	0x1EDC6F41,	0xFFFFFFFF,	1, 1, 0xFFFFFFFF,	0xE3069283),
+	CRC_MODEL("CRC-64/ECMA-182",		64,	0x42F0E1EBA9EA3693,	0x0000000000000000,	0, 0, 0x0000000000000000,	0x6C40DF5F0B497347),
+	CRC_MODEL("CRC-64/WE",				64,	0x42F0E1EBA9EA3693,	0xFFFFFFFFFFFFFFFF,	0, 0, 0xFFFFFFFFFFFFFFFF,	0x62EC59E3F1A4F00A),
+	CRC_MODEL("CRC-64/XZ",				64,	0x42F0E1EBA9EA3693,	0xFFFFFFFFFFFFFFFF,	1, 1, 0xFFFFFFFFFFFFFFFF,	0x995DC9BBDF1939FA),
+	CRC_MODEL("CRC-64/GO-ISO",			64,	0x000000000000001B,	0xFFFFFFFFFFFFFFFF,	1, 1, 0xFFFFFFFFFFFFFFFF,	0xB90956C775A41001),
+};
+
+#define CRC_CATALOGUE_SIZE		(sizeof(crc_catalogue) / sizeof(crc_catalogue[0]))
+
+// running state of one incremental crc: crc_init(), any number of crc_update() on arbitrary chunks, crc_final().
+typedef struct
+{
+	crc_model_t* model;
+	crc_value_t crc_register;				// raw register, in the model's input direction.
+	uint64_t data_len;						// bytes seen so far.
+} crc_context_t;
+
+// crc_calculate_parallel(): below CRC_PARALLEL_MIN_LEN the buffer stays on the calling thread, and no thread gets a chunk
+// shorter than that either. chunk boundaries are kept on CRC_PARALLEL_CHUNK_ALIGN so every engine starts aligned.
+#define CRC_PARALLEL_MIN_LEN		(4 * 1024 * 1024)
+#define CRC_PARALLEL_MAX_THREADS	(64)
+#define CRC_PARALLEL_CHUNK_ALIGN	(64)
+
+// crc_calculate_batch(): messages go through CRC_BATCH_LANES independent registers in lockstep, so the latency chains
+// of the messages overlap. that pays for the crc32 instruction (CRC-32C) at any length, and for the 32 and 64 bit
+// slicing tables below CRC_CLMUL_MIN_LEN or without pclmul; past that, one message at a time through clmul folding wins,
+// and the 16 bit slicing-by-16 loop already beats 4 lanes of slicing-by-8. the lane kernels are written out for 4.
+#define CRC_BATCH_LANES				(4)
+
+// crc_update_iov(): segments under CRC_IOV_MERGE_LEN are gathered into a CRC_IOV_STAGE_LEN staging buffer and go
+// through the engines as one run. a longer one goes straight through in CRC_IOV_BLOCK_LEN blocks, its head tops the
+// staged bytes up to a whole block and its tail (under a block) is staged for the next segment, so no engine is left
+// with a short edge at every boundary. CRC_IOV_BLOCK_LEN is the clmul fold width, a multiple of every slicing step.
+#define CRC_IOV_MERGE_LEN			(256)
+#define CRC_IOV_STAGE_LEN			(1024)
+#define CRC_IOV_BLOCK_LEN			(16)
+
+// one segment of a scatter-gather list. laid out like struct iovec (iov_base, iov_len) on the systems that have one,
+// so an iovec array can go in as it is, cast; there's no <sys/uio.h> everywhere (mingw).
+typedef struct
+{
+	const void* base;
+	size_t len;
+} crc_segment_t;
+
+// crc_copy(): the source goes through the crc a CRC_COPY_BLOCK_LEN block at a time, and each block is copied out while
+// it's still in L1, so the source is read from memory once. from CRC_COPY_STREAM_LEN up the copy is far bigger than
+// the cache it would push out and is never read back here, so it goes out with non-temporal stores, which also skip
+// reading the destination lines in first. those are sse2, always there on x86-64.
+#define CRC_COPY_BLOCK_LEN			(4096)
+#define CRC_COPY_STREAM_LEN			(1024 * 1024)
+#ifdef USE_CLMUL_FOR_CRC
+#define USE_STREAMING_STORES
+#endif // USE_CLMUL_FOR_CRC
+
+// crc_calculate_blocks(): the object register is shifted over every block it takes in. crc_shift_register() is a
+// multiply mod P each time, from CRC_BLOCKS_SHIFT_TABLE_MIN blocks on the shift by one block length is built once as
+// a table per register byte instead (the shift is linear), and is then as cheap as a slicing step.
+#define CRC_BLOCKS_SHIFT_TABLE_MIN	(256)
+
+// crc_correct(): single (and double) bit error correction by syndrome lookup, for frames up to CRC_CORRECT_MAX_LEN bytes.
+// one index per (width, polynomial, directions, frame length), built on first use and kept, like the tables.
+#define CRC_CORRECT_MAX_LEN			(4096)
+#define CRC_SYNDROME_AMBIGUOUS		(UINT32_MAX)		// more than one error position gives this syndrome.
+#define CRC_SYNDROME_NONE			(UINT32_MAX - 1)	// no single bit error gives it.
+
+// syndrome -> error position for one frame length. positions 0 .. 8 * frame_len - 1 are data bits (byte position / 8,
+// bit position % 8, so bit 0 is the 0x01 bit), frame_len * 8 + k is bit k of the received crc.
+typedef struct crc_syndrome_index
+{
+	uint8_t width;
+	crc_value_t polynomial;
+	uint8_t reflect_input;
+	uint8_t reflect_output;
+	size_t frame_len;
+	uint32_t position_count;
+	crc_value_t* position_syndromes;		// per position, what the double bit search runs over.
+	uint32_t slot_mask;
+	crc_value_t* slot_syndromes;			// open addressing, 0 is an empty slot: no single bit error has syndrome 0.
+	uint32_t* slot_positions;
+	struct crc_syndrome_index* next;		// registry chain.
+} crc_syndrome_index_t;
+
+// crc_rolling_*(): the crc of the last window_len bytes of a stream, moved along one byte at a time in O(1), for content
+// defined chunking. the raw register is linear, so a byte leaving the window takes away what it put in, which is the
+// byte run through window_len zero bytes (times x^(8 * window_len) mod P): out_table. the init value's own share of the
+// window is constant, and is folded into out_table too. in_table is the plain byte table, widened to crc_value_t.
+typedef struct
+{
+	crc_model_t* model;
+	size_t window_len;
+	uint8_t width;
+	uint8_t reflected;
+	crc_value_t crc_register;			// raw register of the current window.
+	crc_value_t in_table [256];
+	crc_value_t out_table [256];
+} crc_rolling_t;
+
+#if defined(USE_CONST_TABLES) && !defined(CRICKEY_GENERATE_TABLES)
+#include "crickey_tables.h"
+#endif // USE_CONST_TABLES
+///////////////////////////////////////////////////////////////////		MODEL DEFINES --	///////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////		SPECIALIZED DEFINES ++	///////////////////////////////////////////////////////////////////
+// per-model functions with the whole model fixed at compile time, for hot paths on one known model (hash tables, key checks).
+// CRC_SPECIALIZE(name, type, width, table, reflected, init_register, xorout) makes
+//	type name##_update(type crc_register, const uint8_t* byte_data, size_t data_len)	raw register in, raw register out
+//	type name(const uint8_t* byte_data, size_t data_len)								crc of a message
+//	type name##_4(const uint8_t key [4]), name##_8(...), name##_16(...)					crc of a fixed size key
+// on one of the crickey_tables.h tables. no runtime parameters and no direction branch, slicing-by-8 when the table has the
+// slices, and everything is forced inline, so a constant length (the key functions) unrolls completely. init_register is
+// the register the model starts from, i.e. already reflected for a reflected model. refin == refout models only.
+#if defined(USE_CONST_TABLES) && !defined(CRICKEY_GENERATE_TABLES)
+#define USE_SPECIALIZED_MODELS
+#endif // USE_CONST_TABLES
+
+#ifdef USE_SPECIALIZED_MODELS
+#if defined(__GNUC__)
+#define CRC_UNROLL_8			_Pragma("GCC unroll 8")
+#define CRC_UNROLL_16			_Pragma("GCC unroll 16")
+#else
+#define CRC_UNROLL_8
+#define CRC_UNROLL_16
+#endif // __GNUC__
+
+// one lookup of the slicing-by-8 step: byte n of the block (xored with the register) through slice 7 - n.
+#define CRC_SPECIALIZED_LOOKUP(flat_table, data_word, reflected, n)																\
+		(flat_table)[(7 - (n)) * 256 + (((data_word) >> ((reflected) ? 8 * (n) : 56 - 8 * (n))) & 0xFF)]
+
+#define CRC_SPECIALIZE_UPDATE(name, type, width, table, reflected)																	\
+static CRC_FORCE_INLINE type name##_update(type crc_register, const uint8_t* byte_data, size_t data_len)							\
+{																																	\
+	const type* flat_table = &(table)[0][0];																						\
+	uint64_t data_word;																												\
+																																	\
+	if (sizeof(table) / sizeof((table)[0]) >= CRC_SLICES_8)																			\
+	{																																\
+		CRC_UNROLL_8																												\
+		for (; data_len >= 8; data_len -= 8, byte_data += 8)																		\
+		{																															\
+			data_word = (reflected) ? (crc_load_le64(byte_data) ^ crc_register) :													\
+									  (crc_load_be64(byte_data) ^ ((uint64_t)crc_register << (64 - (width))));						\
+			crc_register = (type)(CRC_SPECIALIZED_LOOKUP(flat_table, data_word, reflected, 0) ^ CRC_SPECIALIZED_LOOKUP(flat_table, data_word, reflected, 1) ^	\
+								  CRC_SPECIALIZED_LOOKUP(flat_table, data_word, reflected, 2) ^ CRC_SPECIALIZED_LOOKUP(flat_table, data_word, reflected, 3) ^	\
+								  CRC_SPECIALIZED_LOOKUP(flat_table, data_word, reflected, 4) ^ CRC_SPECIALIZED_LOOKUP(flat_table, data_word, reflected, 5) ^	\
+								  CRC_SPECIALIZED_LOOKUP(flat_table, data_word, reflected, 6) ^ CRC_SPECIALIZED_LOOKUP(flat_table, data_word, reflected, 7));	\
+		}																															\
+	}																																\
+																																	\
+	CRC_UNROLL_16																													\
+	for (; data_len > 0; data_len--, byte_data++)																					\
+	{																																\
+		crc_register = (reflected) ?	(type)(((uint64_t)crc_register >> 8) ^ flat_table[(crc_register ^ *byte_data) & 0xFF]) :	\
+										(type)(((uint64_t)crc_register << 8) ^ flat_table[((crc_register >> ((width) - 8)) ^ *byte_data) & 0xFF]);	\
+	}																																\
+																																	\
+	return crc_register;																											\
+}
+
+#define CRC_SPECIALIZE_WRAPPERS(name, type, init_register, xorout)																	\
+static CRC_FORCE_INLINE type name(const uint8_t* byte_data, size_t data_len)														\
+{																																	\
+	return (type)(name##_update((type)(init_register), byte_data, data_len) ^ (type)(xorout));										\
+}																																	\
+static CRC_FORCE_INLINE type name##_4(const uint8_t key [4])	{ return name(key, 4); }											\
+static CRC_FORCE_INLINE type name##_8(const uint8_t key [8])	{ return name(key, 8); }											\
+static CRC_FORCE_INLINE type name##_16(const uint8_t key [16])	{ return name(key, 16); }
+
+#define CRC_SPECIALIZE(name, type, width, table, reflected, init_register, xorout)													\
+		CRC_SPECIALIZE_UPDATE(name, type, width, table, reflected)																	\
+		CRC_SPECIALIZE_WRAPPERS(name, type, init_register, xorout)
+#endif // USE_SPECIALIZED_MODELS
+///////////////////////////////////////////////////////////////////		SPECIALIZED DEFINES --	///////////////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////		BENCHMARK DEFINES ++	///////////////////////////////////////////////////////////////////
+// benchmark build: crickey.c built with -DCRICKEY_BENCHMARK runs every engine on every catalogue model over sizes from
+// CRC_BENCH_MIN_LEN to CRC_BENCH_MAX_LEN (x4 steps) and the start offsets in CRC_BENCH_OFFSETS, and prints one line per run
+// as CSV (or a JSON array with -DCRC_BENCH_JSON) on stdout, for tracking between releases and picking engines per host.
+// all of these can be overridden with -D for a shorter run.
+#ifdef CRICKEY_BENCHMARK
+#ifndef CRC_BENCH_MIN_LEN
+#define CRC_BENCH_MIN_LEN			(1)
+#endif // CRC_BENCH_MIN_LEN
+#ifndef CRC_BENCH_MAX_LEN
+#define CRC_BENCH_MAX_LEN			(1024 * 1024 * 1024)
+#endif // CRC_BENCH_MAX_LEN
+#ifndef CRC_BENCH_OFFSETS
+#define CRC_BENCH_OFFSETS			{0, 1, 3}
+#endif // CRC_BENCH_OFFSETS
+// every run repeats the call for at least this long, one call is always made.
+#ifndef CRC_BENCH_MIN_NS
+#define CRC_BENCH_MIN_NS			(20 * 1000 * 1000)
+#endif // CRC_BENCH_MIN_NS
+// an engine stops growing the size once one call would take longer than this (bitwise over 1 GiB takes a while).
+#ifndef CRC_BENCH_MAX_CALL_NS
+#define CRC_BENCH_MAX_CALL_NS		(2000 * 1000 * 1000LL)
+#endif // CRC_BENCH_MAX_CALL_NS
+
+typedef enum
+{
+	CRC_BENCH_BITWISE,
+	CRC_BENCH_NIBBLE,
+	CRC_BENCH_TABLE,
+	CRC_BENCH_SLICING_4,
+	CRC_BENCH_SLICING_8,
+	CRC_BENCH_SLICING_16,
+	CRC_BENCH_CLMUL,
+	CRC_BENCH_HW,
+	CRC_BENCH_MODEL,						// crc_calculate(), whatever it dispatches to.
+	CRC_BENCH_PARALLEL,						// crc_calculate_parallel() with the default threads and threshold.
+	CRC_BENCH_ENGINES
+} crc_bench_engine_t;
+#endif // CRICKEY_BENCHMARK
+///////////////////////////////////////////////////////////////////		BENCHMARK DEFINES --	///////////////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////		CLI DEFINES ++	///////////////////////////////////////////////////////////////////
+// the checksum tool (crickey with arguments): regular files are mapped and hashed in place, no copy into user space,
+// everything else (pipes, stdin, files that won't map) is read in large page aligned blocks.
+#if defined(__unix__) || defined(__APPLE__)
+#define USE_MMAP_FOR_CLI
+#include <sys/mman.h>
+#include <sys/uio.h>						// check_crc_iov(): crc_segment_t against struct iovec.
+#endif // __unix__ || __APPLE__
+
+#ifndef O_BINARY
+#define O_BINARY				(0)
+#endif // O_BINARY
+
+#define CRC_CLI_DEFAULT_MODEL	"CRC-32"
+#define CRC_CLI_READ_BLOCK		(1024 * 1024)
+#define CRC_CLI_READ_ALIGN		(4096)
+#define CRC_CLI_LINE_MAX		(4096)
+///////////////////////////////////////////////////////////////////		CLI DEFINES --	///////////////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////		MANIFEST DEFINES ++	///////////////////////////////////////////////////////////////////
+// checksum manifests of whole directory trees (crickey -r), and checking them back (crickey -c), on a pool of threads.
+// the work is cut into tasks up front: runs of small files are batched into one task up to CRC_MANIFEST_BATCH_LEN bytes or
+// CRC_MANIFEST_BATCH_FILES files, files longer than 2 * CRC_MANIFEST_CHUNK_LEN are cut into chunks whose crcs are put
+// back together with crc_combine(). the tasks are dealt out biggest first, every thread works its own queue from the
+// front, and a thread that runs dry steals from the back of the others, so nobody idles while there's work left.
+// reads block, so there are more threads than cpus by default: the extra ones keep the ssd queue full.
+// the walk and the reads are posix (opendir, lstat, pread), so like USE_MMAP_FOR_CLI there's none of it elsewhere,
+// and no -c / -r.
+#if defined(__unix__) || defined(__APPLE__)
+#define USE_MANIFEST
+#include <dirent.h>
+#endif // __unix__ || __APPLE__
+
+#ifdef USE_MANIFEST
+
+#define CRC_MANIFEST_CHUNK_LEN			(16 * 1024 * 1024)
+#define CRC_MANIFEST_BATCH_LEN			(1024 * 1024)
+#define CRC_MANIFEST_BATCH_FILES		(64)
+#define CRC_MANIFEST_THREADS_PER_CPU	(2)
+#define CRC_MANIFEST_LEN_UNKNOWN		(UINT64_MAX)		// file_len of an entry read back from a manifest, the run stats it.
+
+// holes of sparse files (SEEK_DATA / SEEK_HOLE, where the system and the file system have them) aren't read at all, they
+// go in with crc_update_zeros(). data that is read goes through the crc a CRC_MANIFEST_ZERO_RUN_LEN page at a time
+// as well, all zero pages the same way: those are what's left of holes in files written out without them.
+#define CRC_MANIFEST_ZERO_RUN_LEN		(4096)
+
+// one file of a manifest.
+typedef struct
+{
+	char* path;
+	uint64_t file_len;						// as the walk found it, the chunks are cut on it.
+	crc_value_t calculated_crc;
+	crc_value_t expected_crc;				// from the manifest, see crc_manifest_read().
+	int error;								// errno of the open or read that failed, 0 if calculated_crc is good.
+	uint32_t chunk_count;					// 0 if the file is done in one piece.
+	uint32_t chunks_left;					// the chunk that takes this to 0 puts the crc together.
+	crc_value_t* chunk_crcs;
+} crc_manifest_entry_t;
+
+typedef struct
+{
+	crc_model_t* model;
+	crc_manifest_entry_t* entries;
+	size_t entry_count;
+	size_t entry_capacity;
+	uint64_t chunk_len;						// CRC_MANIFEST_CHUNK_LEN after crc_manifest_init(), can be changed before the run.
+	uint64_t batch_len;						// CRC_MANIFEST_BATCH_LEN, same.
+} crc_manifest_t;
+#endif // USE_MANIFEST
+///////////////////////////////////////////////////////////////////		MANIFEST DEFINES --	///////////////////////////////////////////////////////////////////
+
+
+
 ///////////////////////////////////////////////////////////////////		COMMON FUNCTIONS ++		///////////////////////////////////////////////////////////////////
-// stolen from:  http://www.zlib.net/crc_v3.txt, Ross Williams.
-// Returns the value with the bottom b [0,32] bits reflected.
+// after:  http://www.zlib.net/crc_v3.txt, Ross Williams.
+// Returns the value with the bottom b [0,64] bits reflected.
 // Example: reflect(0x3e23L,3) == 0x3e26
-uint32_t reflect(uint32_t value,uint8_t num_bits_to_reflect)
+// the whole word is reversed with swaps instead of Ross's loop over the bits: crc_register_init() runs this once per
+// crc_calculate() of every reflected model, where a 32 or 64 step loop of unpredictable branches was most of a short message.
+uint64_t reflect(uint64_t value,uint8_t num_bits_to_reflect)
+{
+	uint64_t reversed_value = value;
+
+	if (num_bits_to_reflect == 0)
+	{
+		return value;
+	}
+
+	reversed_value = ((reversed_value >> 1) & 0x5555555555555555ULL) | ((reversed_value & 0x5555555555555555ULL) << 1);
+	reversed_value = ((reversed_value >> 2) & 0x3333333333333333ULL) | ((reversed_value & 0x3333333333333333ULL) << 2);
+	reversed_value = ((reversed_value >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((reversed_value & 0x0F0F0F0F0F0F0F0FULL) << 4);
+	reversed_value = ((reversed_value >> 8) & 0x00FF00FF00FF00FFULL) | ((reversed_value & 0x00FF00FF00FF00FFULL) << 8);
+	reversed_value = ((reversed_value >> 16) & 0x0000FFFF0000FFFFULL) | ((reversed_value & 0x0000FFFF0000FFFFULL) << 16);
+	reversed_value = (reversed_value >> 32) | (reversed_value << 32);
+
+	// the bottom b bits, reversed, land in the top b bits; bring them down and keep the bits above b as they were.
+	return (value & ~CRC_MASK(num_bits_to_reflect)) | (reversed_value >> (64 - num_bits_to_reflect));
+}
+
+
+// for timing engines: the benchmark build and the tuner.
+uint64_t crc_monotonic_ns()
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+
+// a * b mod P in GF(2), P = x^width + polynomial, all in natural order (bit i is x^i, no reflection).
+// one shift-and-reduce per bit of a, the same step the bitwise crc loop does.
+crc_value_t multiply_mod_crc(crc_value_t a, crc_value_t b, crc_value_t polynomial, uint8_t width)
 {
-	int bit_index;
-	uint32_t temp_value = value;
-	for (bit_index = 0; bit_index < num_bits_to_reflect; bit_index++)
+	crc_value_t product = 0;
+	int8_t bit_index;
+
+	for (bit_index = width - 1; bit_index >= 0; bit_index--)
 	{
-		if (temp_value & (uint32_t)1)
-			value |=  BITMASK((num_bits_to_reflect-1)-bit_index);
+		// product = product * x mod P
+		if ((product & TOPBIT(width)) != 0)
+		{
+			product = ((product << 1) ^ polynomial) & CRC_MASK(width);
+		}
 		else
-			value &= ~BITMASK((num_bits_to_reflect-1)-bit_index);
+		{
+			product = (product << 1) & CRC_MASK(width);
+		}
+
+		if ((a >> bit_index) & 1)
+		{
+			product ^= b;
+		}
+	}
+
+	return product;
+}
+
+
+// the checks' test data: a 32 bit lcg (the numerical recipes constants), the same bytes for the same seed on every run,
+// so a failing check fails again. crc_test_random() steps the state and returns it, a data byte is its bits 16..23.
+uint32_t crc_test_random(uint32_t* random_state)
+{
+	*random_state = *random_state * 1103515245 + 12345;
 
-		temp_value >>= 1;
+	return *random_state;
+}
+
+
+// data_len test bytes from random_state. returns the state after the last one, to go on drawing from.
+uint32_t fill_crc_test_data(uint8_t* byte_data, size_t data_len, uint32_t random_state)
+{
+	size_t data_index;
+
+	for (data_index = 0; data_index < data_len; data_index++)
+	{
+		byte_data[data_index] = (uint8_t)(crc_test_random(&random_state) >> 16);
 	}
 
-	return value;
+	return random_state;
 }
 ///////////////////////////////////////////////////////////////////		COMMON FUNCTIONS --		///////////////////////////////////////////////////////////////////
 
 
 
+///////////////////////////////////////////////////////////////////		CLMUL FUNCTIONS ++		///////////////////////////////////////////////////////////////////
+#ifdef USE_CLMUL_FOR_CRC
+int crc_clmul_available()
+{
+	return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+}
+
+
+// x^exponent mod P', P' = x^32 + polynomial (natural order, bit i is x^i).
+static uint32_t xpow_mod_crc_clmul(uint32_t exponent, uint32_t polynomial)
+{
+	uint32_t remainder = 1;
+
+	while (exponent--)
+	{
+		remainder = (remainder & 0x80000000) ? (remainder << 1) ^ polynomial : (remainder << 1);
+	}
+
+	return remainder;
+}
+
+
+// bit-reversed 64 bit form of a 32 bit remainder: bit i moves to bit 63-i.
+#define CRC_CLMUL_REFLECT_64(value)		(reflect((value),32) << 32)
+// bit-reversed 33 bit form of a 33 bit value: bit i moves to bit 32-i.
+#define CRC_CLMUL_REFLECT_33(value)		((reflect((uint32_t)(value),32) << 1) | ((value) >> 32))
+
+
+// folding by D bits replaces the top 64 bits of an accumulator by their product with x^(D+64) mod P', and the bottom 64 by x^D mod P'.
+// in the reflected domain the carry-less product of two bit-reversed values comes out one position short (it is the reversed
+// product times x), so there every exponent is one less, and the 96 -> 64 step multiplies a 32 bit value, hence the 33 bit form.
+void generate_crc_clmul_constants(crc_clmul_constants_t* constants, uint32_t generator_polynomial, uint8_t width, uint8_t reflected)
+{
+	uint32_t polynomial = generator_polynomial << (32 - width);
+	uint64_t full_polynomial = (1ULL << 32) | polynomial;
+	uint64_t barrett_mu = 0, remainder = 0;
+	int8_t bit_index;
+
+	// floor(x^64 / P') by long division, one dividend bit at a time.
+	for (bit_index = 64; bit_index >= 0; bit_index--)
+	{
+		remainder = (remainder << 1) | (bit_index == 64);
+		barrett_mu <<= 1;
+		if (remainder & (1ULL << 32))
+		{
+			remainder ^= full_polynomial;
+			barrett_mu |= 1;
+		}
+	}
+
+	constants->width = width;
+	constants->reflected = reflected;
+
+	if (reflected != 1)
+	{
+		constants->fold_by_4[0] = xpow_mod_crc_clmul(4*128, polynomial);
+		constants->fold_by_4[1] = xpow_mod_crc_clmul(4*128 + 64, polynomial);
+		constants->fold_by_1[0] = xpow_mod_crc_clmul(128, polynomial);
+		constants->fold_by_1[1] = xpow_mod_crc_clmul(128 + 64, polynomial);
+		constants->reduce_96 = xpow_mod_crc_clmul(96, polynomial);
+		constants->reduce_64 = xpow_mod_crc_clmul(64, polynomial);
+		constants->barrett_mu = barrett_mu;
+		constants->barrett_poly = full_polynomial;
+	}
+	else
+	{
+		// the low lane of a reflected accumulator holds the top (first) 64 bits, so the constants swap lanes too.
+		constants->fold_by_4[0] = CRC_CLMUL_REFLECT_64(xpow_mod_crc_clmul(4*128 + 64 - 1, polynomial));
+		constants->fold_by_4[1] = CRC_CLMUL_REFLECT_64(xpow_mod_crc_clmul(4*128 - 1, polynomial));
+		constants->fold_by_1[0] = CRC_CLMUL_REFLECT_64(xpow_mod_crc_clmul(128 + 64 - 1, polynomial));
+		constants->fold_by_1[1] = CRC_CLMUL_REFLECT_64(xpow_mod_crc_clmul(128 - 1, polynomial));
+		constants->reduce_96 = CRC_CLMUL_REFLECT_64(xpow_mod_crc_clmul(96 - 1, polynomial));
+		constants->reduce_64 = reflect(xpow_mod_crc_clmul(64, polynomial),32) << 1;
+		constants->barrett_mu = CRC_CLMUL_REFLECT_33(barrett_mu);
+		constants->barrett_poly = CRC_CLMUL_REFLECT_33(full_polynomial);
+	}
+}
+
+
+__attribute__((target("pclmul,ssse3")))
+static inline uint64_t clmul_64(uint64_t a, uint64_t b)
+{
+	return (uint64_t)_mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_cvtsi64_si128((int64_t)a), _mm_cvtsi64_si128((int64_t)b), 0x00));
+}
+
+
+// one fold step: accumulator * x^D mod P' (two 64x32 bit products), then xor in the next 128 bits of data.
+__attribute__((target("pclmul,ssse3")))
+static inline __m128i fold_crc_clmul(__m128i accumulator, __m128i fold_constant, __m128i next_data)
+{
+	return _mm_xor_si128(_mm_xor_si128(	_mm_clmulepi64_si128(accumulator, fold_constant, 0x00),
+										_mm_clmulepi64_si128(accumulator, fold_constant, 0x11)), next_data);
+}
+
+
+// runs the 32 bit (scaled) register over data_len bytes, data_len must be a multiple of 16 and at least 16.
+// normal direction: the data is byte-reversed per 128 bits so that bit i of the accumulator is x^i, the register sits at the top.
+// reflected direction: the data is taken as loaded, bit i of the accumulator is x^(127-i), the register sits at the bottom.
+__attribute__((target("pclmul,ssse3"), always_inline))
+static inline uint32_t update_crc_clmul_direction(const crc_clmul_constants_t* constants, uint32_t calculated_crc, const uint8_t* byte_data, size_t data_len, const uint8_t reflected)
+{
+	const __m128i byte_reverse = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+	const __m128i fold_by_4 = _mm_loadu_si128((const __m128i*)constants->fold_by_4);
+	const __m128i fold_by_1 = _mm_loadu_si128((const __m128i*)constants->fold_by_1);
+	__m128i accumulator0, accumulator1, accumulator2, accumulator3, reduced;
+	uint64_t remainder, quotient;
+
+#define CRC_CLMUL_LOAD(offset)	(reflected ?	_mm_loadu_si128((const __m128i*)(byte_data + (offset))) : \
+												_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(byte_data + (offset))), byte_reverse))
+
+	// the initial register is xored into the first 32 bits of data.
+	accumulator0 = CRC_CLMUL_LOAD(0);
+	accumulator0 = _mm_xor_si128(accumulator0, reflected ? _mm_cvtsi32_si128((int32_t)calculated_crc) : _mm_slli_si128(_mm_cvtsi32_si128((int32_t)calculated_crc), 12));
+	byte_data += 16;
+	data_len -= 16;
+
+	if (data_len >= 48 + 64)
+	{
+		accumulator1 = CRC_CLMUL_LOAD(0);
+		accumulator2 = CRC_CLMUL_LOAD(16);
+		accumulator3 = CRC_CLMUL_LOAD(32);
+		byte_data += 48;
+		data_len -= 48;
+
+		while (data_len >= 64)
+		{
+			accumulator0 = fold_crc_clmul(accumulator0, fold_by_4, CRC_CLMUL_LOAD(0));
+			accumulator1 = fold_crc_clmul(accumulator1, fold_by_4, CRC_CLMUL_LOAD(16));
+			accumulator2 = fold_crc_clmul(accumulator2, fold_by_4, CRC_CLMUL_LOAD(32));
+			accumulator3 = fold_crc_clmul(accumulator3, fold_by_4, CRC_CLMUL_LOAD(48));
+			byte_data += 64;
+			data_len -= 64;
+		}
+
+		accumulator0 = fold_crc_clmul(accumulator0, fold_by_1, accumulator1);
+		accumulator0 = fold_crc_clmul(accumulator0, fold_by_1, accumulator2);
+		accumulator0 = fold_crc_clmul(accumulator0, fold_by_1, accumulator3);
+	}
+
+	while (data_len >= 16)
+	{
+		accumulator0 = fold_crc_clmul(accumulator0, fold_by_1, CRC_CLMUL_LOAD(0));
+		byte_data += 16;
+		data_len -= 16;
+	}
+
+#undef CRC_CLMUL_LOAD
+
+	// what is left is the crc of the 128 bit accumulator A, i.e. A * x^32 mod P'.
+	if (reflected != 1)
+	{
+		// top 64 bits * x^96 mod P' plus the bottom 64 bits * x^32: 96 bits.
+		reduced = _mm_xor_si128(_mm_clmulepi64_si128(accumulator0, _mm_cvtsi64_si128((int64_t)constants->reduce_96), 0x01),
+								_mm_slli_si128(_mm_move_epi64(accumulator0), 4));
+		// top 32 bits * x^64 mod P' plus the bottom 64 bits: 64 bits.
+		reduced = _mm_xor_si128(_mm_clmulepi64_si128(reduced, _mm_cvtsi64_si128((int64_t)constants->reduce_64), 0x01),
+								_mm_move_epi64(reduced));
+		remainder = (uint64_t)_mm_cvtsi128_si64(reduced);
+
+		// barrett: quotient = floor(floor(remainder / x^32) * mu / x^32), crc = remainder - quotient * P'.
+		quotient = clmul_64(remainder >> 32, constants->barrett_mu) >> 32;
+		return (uint32_t)(remainder ^ clmul_64(quotient, constants->barrett_poly));
+	}
+	else
+	{
+		reduced = _mm_xor_si128(_mm_clmulepi64_si128(accumulator0, _mm_cvtsi64_si128((int64_t)constants->reduce_96), 0x00),
+								_mm_slli_si128(_mm_srli_si128(accumulator0, 8), 4));
+		remainder = (uint64_t)_mm_cvtsi128_si64(_mm_srli_si128(reduced, 8)) ^
+					clmul_64((uint64_t)_mm_cvtsi128_si64(reduced) >> 32, constants->reduce_64);
+
+		// same barrett reduction, mirrored: the low 32 bits are the top of the remainder, the crc comes out in the high 32.
+		quotient = clmul_64(remainder & 0xFFFFFFFF, constants->barrett_mu) & 0xFFFFFFFF;
+		return (uint32_t)((remainder ^ clmul_64(quotient, constants->barrett_poly)) >> 32);
+	}
+}
+
+
+// entry point: runs the raw register of the constants' width and direction over data_len bytes (a multiple of 16, at least 16).
+// dispatches on direction once, so each direction gets a branch-free loop. a normal register narrower than 32 bits rides
+// in the top of the 32 bit one, a reflected one already sits at the bottom.
+__attribute__((target("pclmul,ssse3")))
+uint32_t update_crc_clmul(const crc_clmul_constants_t* constants, uint32_t calculated_crc, const uint8_t* byte_data, size_t data_len)
+{
+	uint8_t register_shift = 32 - constants->width;
+
+	if (constants->reflected == 1)
+	{
+		return update_crc_clmul_direction(constants, calculated_crc, byte_data, data_len, 1);
+	}
+
+	return update_crc_clmul_direction(constants, calculated_crc << register_shift, byte_data, data_len, 0) >> register_shift;
+}
+
+
+// x^exponent mod P, P = x^64 + polynomial (natural order).
+static uint64_t xpow_mod_crc64_clmul(uint32_t exponent, uint64_t polynomial)
+{
+	uint64_t remainder = 1;
+
+	while (exponent--)
+	{
+		remainder = (remainder >> 63) ? (remainder << 1) ^ polynomial : (remainder << 1);
+	}
+
+	return remainder;
+}
+
+
+// same as generate_crc_clmul_constants(), for a 64 bit polynomial. here the reflected constants are plain 64 bit reversals,
+// with the exponent one less for the short reflected product.
+void generate_crc_clmul64_constants(crc_clmul64_constants_t* constants, uint64_t polynomial, uint8_t reflected)
+{
+	uint64_t barrett_mu = 0, remainder = 0, carry;
+	int16_t bit_index;
+
+	// floor(x^128 / P) by long division. the 65th remainder bit is the one shifted out at the top, the x^64 term of
+	// the quotient falls off the top of barrett_mu the same way.
+	for (bit_index = 128; bit_index >= 0; bit_index--)
+	{
+		carry = remainder >> 63;
+		remainder = (remainder << 1) | (bit_index == 128);
+		barrett_mu <<= 1;
+		if (carry)
+		{
+			remainder ^= polynomial;
+			barrett_mu |= 1;
+		}
+	}
+
+	constants->reflected = reflected;
+
+	if (reflected != 1)
+	{
+		constants->fold_by_4[0] = xpow_mod_crc64_clmul(4*128, polynomial);
+		constants->fold_by_4[1] = xpow_mod_crc64_clmul(4*128 + 64, polynomial);
+		constants->fold_by_1[0] = xpow_mod_crc64_clmul(128, polynomial);
+		constants->fold_by_1[1] = xpow_mod_crc64_clmul(128 + 64, polynomial);
+		constants->reduce_128 = xpow_mod_crc64_clmul(128, polynomial);
+		constants->barrett_mu = barrett_mu;
+		constants->barrett_poly = polynomial;
+	}
+	else
+	{
+		constants->fold_by_4[0] = reflect(xpow_mod_crc64_clmul(4*128 + 64 - 1, polynomial),64);
+		constants->fold_by_4[1] = reflect(xpow_mod_crc64_clmul(4*128 - 1, polynomial),64);
+		constants->fold_by_1[0] = reflect(xpow_mod_crc64_clmul(128 + 64 - 1, polynomial),64);
+		constants->fold_by_1[1] = reflect(xpow_mod_crc64_clmul(128 - 1, polynomial),64);
+		constants->reduce_128 = reflect(xpow_mod_crc64_clmul(128 - 1, polynomial),64);
+		constants->barrett_mu = reflect(barrett_mu,64);
+		constants->barrett_poly = reflect(polynomial,64);
+	}
+}
+
+
+__attribute__((target("pclmul,ssse3")))
+static inline __m128i clmul_64_128(uint64_t a, uint64_t b)
+{
+	return _mm_clmulepi64_si128(_mm_cvtsi64_si128((int64_t)a), _mm_cvtsi64_si128((int64_t)b), 0x00);
+}
+
+
+// update_crc_clmul_direction() for the 64 bit register: same folding, only the register goes into (and the crc comes out of)
+// 64 bits of the accumulator, and the final 128 bits reduce in one x^128 step plus barrett.
+__attribute__((target("pclmul,ssse3"), always_inline))
+static inline uint64_t update_crc_clmul64_direction(const crc_clmul64_constants_t* constants, uint64_t calculated_crc, const uint8_t* byte_data, size_t data_len, const uint8_t reflected)
+{
+	const __m128i byte_reverse = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+	const __m128i fold_by_4 = _mm_loadu_si128((const __m128i*)constants->fold_by_4);
+	const __m128i fold_by_1 = _mm_loadu_si128((const __m128i*)constants->fold_by_1);
+	__m128i accumulator0, accumulator1, accumulator2, accumulator3, reduced, product;
+	uint64_t remainder_high, remainder_low, quotient;
+
+#define CRC_CLMUL_LOAD(offset)	(reflected ?	_mm_loadu_si128((const __m128i*)(byte_data + (offset))) : \
+												_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(byte_data + (offset))), byte_reverse))
+
+	// the initial register is xored into the first 64 bits of data.
+	accumulator0 = CRC_CLMUL_LOAD(0);
+	accumulator0 = _mm_xor_si128(accumulator0, reflected ? _mm_cvtsi64_si128((int64_t)calculated_crc) : _mm_slli_si128(_mm_cvtsi64_si128((int64_t)calculated_crc), 8));
+	byte_data += 16;
+	data_len -= 16;
+
+	if (data_len >= 48 + 64)
+	{
+		accumulator1 = CRC_CLMUL_LOAD(0);
+		accumulator2 = CRC_CLMUL_LOAD(16);
+		accumulator3 = CRC_CLMUL_LOAD(32);
+		byte_data += 48;
+		data_len -= 48;
+
+		while (data_len >= 64)
+		{
+			accumulator0 = fold_crc_clmul(accumulator0, fold_by_4, CRC_CLMUL_LOAD(0));
+			accumulator1 = fold_crc_clmul(accumulator1, fold_by_4, CRC_CLMUL_LOAD(16));
+			accumulator2 = fold_crc_clmul(accumulator2, fold_by_4, CRC_CLMUL_LOAD(32));
+			accumulator3 = fold_crc_clmul(accumulator3, fold_by_4, CRC_CLMUL_LOAD(48));
+			byte_data += 64;
+			data_len -= 64;
+		}
+
+		accumulator0 = fold_crc_clmul(accumulator0, fold_by_1, accumulator1);
+		accumulator0 = fold_crc_clmul(accumulator0, fold_by_1, accumulator2);
+		accumulator0 = fold_crc_clmul(accumulator0, fold_by_1, accumulator3);
+	}
+
+	while (data_len >= 16)
+	{
+		accumulator0 = fold_crc_clmul(accumulator0, fold_by_1, CRC_CLMUL_LOAD(0));
+		byte_data += 16;
+		data_len -= 16;
+	}
+
+#undef CRC_CLMUL_LOAD
+
+	// the crc of the 128 bit accumulator A is A * x^64 mod P: top 64 bits * x^128 mod P plus the bottom 64 bits * x^64,
+	// then barrett on what is left: quotient = floor(high * mu / x^64), crc = low - quotient * P.
+	if (reflected != 1)
+	{
+		reduced = _mm_xor_si128(_mm_clmulepi64_si128(accumulator0, _mm_cvtsi64_si128((int64_t)constants->reduce_128), 0x01),
+								_mm_slli_si128(accumulator0, 8));
+		remainder_high = (uint64_t)_mm_cvtsi128_si64(_mm_srli_si128(reduced, 8));
+		remainder_low = (uint64_t)_mm_cvtsi128_si64(reduced);
+
+		quotient = remainder_high ^ (uint64_t)_mm_cvtsi128_si64(_mm_srli_si128(clmul_64_128(remainder_high, constants->barrett_mu), 8));
+		return remainder_low ^ (uint64_t)_mm_cvtsi128_si64(clmul_64_128(quotient, constants->barrett_poly));
+	}
+	else
+	{
+		// mirrored: the low lane is the top of the remainder. the reflected products come out one bit short, so the quotient
+		// (the top half of a product) is shifted up by one, and the bottom half of the other product is bits 63..126.
+		reduced = _mm_xor_si128(_mm_clmulepi64_si128(accumulator0, _mm_cvtsi64_si128((int64_t)constants->reduce_128), 0x00),
+								_mm_srli_si128(accumulator0, 8));
+		remainder_high = (uint64_t)_mm_cvtsi128_si64(reduced);
+		remainder_low = (uint64_t)_mm_cvtsi128_si64(_mm_srli_si128(reduced, 8));
+
+		quotient = remainder_high ^ ((uint64_t)_mm_cvtsi128_si64(clmul_64_128(remainder_high, constants->barrett_mu)) << 1);
+		product = clmul_64_128(quotient, constants->barrett_poly);
+		return remainder_low ^ (((uint64_t)_mm_cvtsi128_si64(_mm_srli_si128(product, 8)) << 1) | ((uint64_t)_mm_cvtsi128_si64(product) >> 63));
+	}
+}
+
+
+// entry point for the 64 bit register, data_len a multiple of 16 and at least 16.
+__attribute__((target("pclmul,ssse3")))
+uint64_t update_crc_clmul64(const crc_clmul64_constants_t* constants, uint64_t calculated_crc, const uint8_t* byte_data, size_t data_len)
+{
+	if (constants->reflected == 1)
+	{
+		return update_crc_clmul64_direction(constants, calculated_crc, byte_data, data_len, 1);
+	}
+
+	return update_crc_clmul64_direction(constants, calculated_crc, byte_data, data_len, 0);
+}
+#endif // #ifdef USE_CLMUL_FOR_CRC
+///////////////////////////////////////////////////////////////////		CLMUL FUNCTIONS --		///////////////////////////////////////////////////////////////////
+
+
+
 ///////////////////////////////////////////////////////////////////		CRC8 FUNCTIONS ++	///////////////////////////////////////////////////////////////////
 #ifdef USE_TABLE_FOR_CRC_8
 void generate_crc8_table(uint8_t generator_polynomial)
@@ -107,6 +1240,7 @@ void generate_crc8_table(uint8_t generator_polynomial)
 	uint16_t byte_value;
 	uint8_t bit_index;
 	uint8_t crc_value;
+	uint8_t reflected_polynomial = (uint8_t)reflect(generator_polynomial,CRC_WIDTH_8);
 
 	// iterate over all byte values 0 - 255
 	for (byte_value = 0; byte_value < 256; byte_value++)
@@ -129,6 +1263,23 @@ void generate_crc8_table(uint8_t generator_polynomial)
 		/* store CRC value in lookup table */
 		crc8_table[byte_value] = crc_value;
 
+		// same again for the reflected (LSB-first) register: the byte goes into the LSB, the register shifts right,
+		// and the polynomial is bit-reversed. this is the table used for refin=true models.
+		crc_value = byte_value;
+
+		for (bit_index = 0; bit_index < 8; bit_index++)
+		{
+			if ((crc_value & 1) != 0)
+			{
+				crc_value = (crc_value >> 1) ^ reflected_polynomial;
+			}
+			else
+			{
+				crc_value >>= 1;
+			}
+		}
+		crc8_table_reflected[byte_value] = crc_value;
+
 	}
 }
 #endif // #ifdef USE_TABLE_FOR_CRC_8
@@ -148,41 +1299,61 @@ void print_crc8_table()
 	}
 
 	printf("};\n\n");
+
+	printf("crc8_table_reflected == \n{\n");
+
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		printf("%02X,\n",crc8_table_reflected[byte_value]);
+	}
+
+	printf("};\n\n");
 }
 #endif // #ifdef USE_TABLE_FOR_CRC_8
 
 
-uint8_t calculate_crc8(	uint8_t* byte_data,
-						int32_t data_len,
-						uint8_t crc_config_initial_value,
-						uint8_t crc_config_final_xor_value,
-						uint8_t crc_config_polynomial,
-						uint8_t crc_config_reflect_input,
-						uint8_t crc_config_reflect_output )
+// runs the raw crc register over the data one bit at a time, straight from the definition: nothing precalculated.
+// the register is kept in the input direction of the model, reflected (LSB-first) for refin=true models and normal
+// (MSB-first) otherwise, so no input byte ever needs reflecting. every other engine is checked against this one.
+uint8_t update_crc8_bitwise(	uint8_t crc_config_polynomial,
+							uint8_t calculated_crc,
+							const uint8_t* byte_data,
+							size_t data_len,
+							uint8_t reflected )
 {
-	int32_t byte_data_index, bit_index;
-
-	uint8_t calculated_crc = crc_config_initial_value ;
+	size_t byte_data_index;
+	uint8_t bit_index;
+	uint8_t reflected_polynomial = (uint8_t)reflect(crc_config_polynomial,CRC_WIDTH_8);
 
-	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	if(reflected == 1)
 	{
-		// xor in the next input byte, at the MSB.
-		if(crc_config_reflect_input == 1)
-		{
-			//			printf("data: 0x%02X, reflected: 0x%02X\n",byte_data[byte_data_index], reflect(byte_data[byte_data_index],8));
-			calculated_crc ^= reflect(byte_data[byte_data_index],8) << (CRC_WIDTH_8-8);
-		}
-		else
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
 		{
-			calculated_crc ^= byte_data[byte_data_index] << (CRC_WIDTH_8-8);
-		}
+			// xor in the next input byte, **at the LSB**
+			calculated_crc ^= byte_data[byte_data_index];
 
-#ifdef USE_TABLE_FOR_CRC_8
+			// calculate crc by iterating over each bit of current byte and applying the reflected polynomial.
+			for (bit_index = 0; bit_index < 8; bit_index++)
+			{
+				// if the LSbit is 1, right-shift and apply the polynomial, else just right-shift
+				if ((calculated_crc & 1) != 0)
+				{
+					calculated_crc = (calculated_crc >> 1) ^ reflected_polynomial;
+				}
+				else
+				{
+					calculated_crc >>= 1;
+				}
+			}
+		}
 
-		// look up the precalc CRC from table:
-		calculated_crc = (crc8_table[calculated_crc]);
+		return calculated_crc;
+	}
 
-#else
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	{
+		// xor in the next input byte, **at the MSB**
+		calculated_crc ^= byte_data[byte_data_index] << (CRC_WIDTH_8-8);
 
 		// calculate crc by iterating over each bit of current byte and applying polynomial.
 		for (bit_index = 0; bit_index < 8; bit_index++)
@@ -197,22 +1368,175 @@ uint8_t calculate_crc8(	uint8_t* byte_data,
 				calculated_crc <<= 1;
 			}
 		}
-#endif // USE_TABLE_FOR_CRC_8
 
 		// at this point, we have the calculated crc upto the current byte.
 	}
 
+	return calculated_crc;
+}
 
-	// xor with final_xor_value:
-	if(crc_config_reflect_output == 1)
+
+#ifdef USE_TABLE_FOR_CRC_8
+// same as update_crc8_bitwise(), one table lookup per byte. the table has to match the register direction,
+// i.e. crc8_table or crc8_table_reflected as built by generate_crc8_table(), or a registry table.
+uint8_t update_crc8_table(	const uint8_t* table,
+						uint8_t calculated_crc,
+						const uint8_t* byte_data,
+						size_t data_len,
+						uint8_t reflected )
+{
+	size_t byte_data_index;
+
+	if(reflected == 1)
 	{
-		calculated_crc = (reflect(calculated_crc,CRC_WIDTH_8) & CRC_MASK(CRC_WIDTH_8)) ^ crc_config_final_xor_value;
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+		{
+			// xor in the next input byte, **at the LSB**
+			calculated_crc ^= byte_data[byte_data_index];
+
+			// look up the precalc CRC from the reflected table, the register is only 8 bits wide so nothing is left over to shift in.
+			calculated_crc = (table[calculated_crc]);
+		}
+
+		return calculated_crc;
 	}
-	else
+
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	{
+		// xor in the next input byte, **at the MSB**
+		calculated_crc ^= byte_data[byte_data_index] << (CRC_WIDTH_8-8);
+
+		// look up the precalc CRC from table:
+		calculated_crc = (table[calculated_crc]);
+
+		// at this point, we have the calculated crc upto the current byte.
+	}
+
+	return calculated_crc;
+}
+#endif // #ifdef USE_TABLE_FOR_CRC_8
+
+
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_8
+// 16 entry tables for update_crc8_nibble(): the register after 4 shift steps, starting from each nibble value at the
+// end of the register the data goes in at. both directions, like generate_crc8_table().
+void generate_crc8_nibble_table(uint8_t generator_polynomial)
+{
+	uint8_t nibble_value;
+	uint8_t bit_index;
+	uint8_t crc_value;
+	uint8_t reflected_polynomial = (uint8_t)reflect(generator_polynomial,CRC_WIDTH_8);
+
+	// iterate over all nibble values 0 - 15
+	for (nibble_value = 0; nibble_value < 16; nibble_value++)
+	{
+		crc_value = nibble_value << (CRC_WIDTH_8 - 4); // move nibble into the top 4 bits of the register
+
+		for (bit_index = 0; bit_index < 4; bit_index++)
+		{
+			if ((crc_value & TOPBIT(CRC_WIDTH_8)) != 0)
+			{
+				crc_value = (crc_value << 1) ^ generator_polynomial;
+			}
+			else
+			{
+				crc_value <<= 1;
+			}
+		}
+		crc8_nibble_table[nibble_value] = crc_value;
+
+		// reflected (LSB-first) register: the nibble goes into the low 4 bits, the register shifts right.
+		crc_value = nibble_value;
+
+		for (bit_index = 0; bit_index < 4; bit_index++)
+		{
+			if ((crc_value & 1) != 0)
+			{
+				crc_value = (crc_value >> 1) ^ reflected_polynomial;
+			}
+			else
+			{
+				crc_value >>= 1;
+			}
+		}
+		crc8_nibble_table_reflected[nibble_value] = crc_value;
+	}
+}
+
+
+// same as update_crc8_table(), but with two lookups per byte in a 16 entry table instead of one in a 256 entry table:
+// the register is advanced 4 bits at a time. the table has to match the register direction, i.e. crc8_nibble_table or
+// crc8_nibble_table_reflected as built by generate_crc8_nibble_table(), or a registry nibble table.
+uint8_t update_crc8_nibble(	const uint8_t* table,
+							uint8_t calculated_crc,
+							const uint8_t* byte_data,
+							size_t data_len,
+							uint8_t reflected )
+{
+	size_t byte_data_index;
+
+	if(reflected == 1)
+	{
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+		{
+			// xor in the next input byte, **at the LSB**
+			calculated_crc ^= byte_data[byte_data_index];
+
+			// the low nibble leaves the register first: it's the index, shift it out and xor in what it leaves behind. twice per byte.
+			calculated_crc = (calculated_crc >> 4) ^ table[calculated_crc & 0x0F];
+			calculated_crc = (calculated_crc >> 4) ^ table[calculated_crc & 0x0F];
+		}
+
+		return calculated_crc;
+	}
+
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	{
+		// xor in the next input byte, **at the MSB**
+		calculated_crc ^= byte_data[byte_data_index] << (CRC_WIDTH_8-8);
+
+		// the top nibble is the index this time, high nibble first.
+		calculated_crc = (calculated_crc << 4) ^ table[calculated_crc >> 4];
+		calculated_crc = (calculated_crc << 4) ^ table[calculated_crc >> 4];
+	}
+
+	return calculated_crc;
+}
+#endif // #ifdef USE_NIBBLE_TABLE_FOR_CRC_8
+
+
+uint8_t calculate_crc8(	uint8_t* byte_data,
+					int32_t data_len,
+					uint8_t crc_config_initial_value,
+					uint8_t crc_config_final_xor_value,
+					uint8_t crc_config_polynomial,
+					uint8_t crc_config_reflect_input,
+					uint8_t crc_config_reflect_output )
+{
+	// refin=true models are run natively on a reflected (LSB-first) register, instead of reflecting every input byte
+	// and then the whole crc again at the end. the register, the polynomial and the table are all bit-reversed,
+	// so the input byte goes in at the LSB untouched and the register shifts right.
+	uint8_t reflected = (crc_config_reflect_input == 1);
+	size_t remaining_len = (data_len > 0) ? (size_t)data_len : 0;
+	uint8_t calculated_crc = reflected ? (uint8_t)reflect(crc_config_initial_value,CRC_WIDTH_8) : crc_config_initial_value;
+
+#ifdef USE_TABLE_FOR_CRC_8
+	calculated_crc = update_crc8_table(reflected ? crc8_table_reflected : crc8_table,calculated_crc,byte_data,remaining_len,reflected);
+#elif defined(USE_NIBBLE_TABLE_FOR_CRC_8)
+	calculated_crc = update_crc8_nibble(reflected ? crc8_nibble_table_reflected : crc8_nibble_table,calculated_crc,byte_data,remaining_len,reflected);
+#else
+	calculated_crc = update_crc8_bitwise(crc_config_polynomial,calculated_crc,byte_data,remaining_len,reflected);
+#endif // USE_TABLE_FOR_CRC_8
+
+	// the register is in the input direction, it only needs reflecting if the output direction is different.
+	if(reflected != (crc_config_reflect_output == 1))
 	{
-		calculated_crc ^= crc_config_final_xor_value;
+		calculated_crc = (reflect(calculated_crc,CRC_WIDTH_8) & CRC_MASK(CRC_WIDTH_8));
 	}
 
+	// xor with final_xor_value:
+	calculated_crc ^= crc_config_final_xor_value;
+
 //	printf("calculated_crc_8 = 0x%02X\n",calculated_crc);
 
 	return calculated_crc;
@@ -229,6 +1553,9 @@ int check_crc_8_algo()
 #ifdef USE_TABLE_FOR_CRC_8
 	generate_crc8_table(0x07); // required if testing table based implementation.
 #endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_8
+	generate_crc8_nibble_table(0x07);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_8
 	if( 0xF4 != calculate_crc8((uint8_t*)"123456789",9,0x00,0x00,0x07,0,0) )
 	{
 		printf ("CRC-8 reference check failed!\n\n");
@@ -247,6 +1574,9 @@ int check_crc_8_algo()
 #ifdef USE_TABLE_FOR_CRC_8
 	generate_crc8_table(0x9B); // required if testing table based implementation.
 #endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_8
+	generate_crc8_nibble_table(0x9B);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_8
 	if( 0xDA != calculate_crc8((uint8_t*)"123456789",9,0xFF,0x00,0x9B,0,0) )
 	{
 		printf ("CRC-8/CDMA2000 reference check failed!\n\n");
@@ -264,6 +1594,9 @@ int check_crc_8_algo()
 #ifdef USE_TABLE_FOR_CRC_8
 	generate_crc8_table(0x07); // required if testing table based implementation.
 #endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_8
+	generate_crc8_nibble_table(0x07);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_8
 	if( 0xA1 != calculate_crc8((uint8_t*)"123456789",9,0x00,0x55,0x07,0,0) )
 	{
 		printf ("CRC-8/ITU reference check failed!\n\n");
@@ -281,6 +1614,9 @@ int check_crc_8_algo()
 #ifdef USE_TABLE_FOR_CRC_8
 	generate_crc8_table(0x39); // required if testing table based implementation.
 #endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_8
+	generate_crc8_nibble_table(0x39);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_8
 	if( 0x15 != calculate_crc8((uint8_t*)"123456789",9,0x00,0x00,0x39,1,1) )
 	{
 		printf ("CRC-8/DARC reference check failed!\n\n");
@@ -293,6 +1629,43 @@ int check_crc_8_algo()
 	data_array [9] = 0x15;
 //	printf("crc including crc: %02X\n",calculate_crc8(data_array,10,0x00,0x00,0x39,1,1));
 
+
+	// reflected table, init value is reflected as well
+	// CRC-8/MAXIM : width=8 poly=0x31 init=0x00 refin=true refout=true xorout=0x00 check=0xa1 name="CRC-8/MAXIM"
+#ifdef USE_TABLE_FOR_CRC_8
+	generate_crc8_table(0x31); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_8
+	generate_crc8_nibble_table(0x31);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_8
+	if( 0xA1 != calculate_crc8((uint8_t*)"123456789",9,0x00,0x00,0x31,1,1) )
+	{
+		printf ("CRC-8/MAXIM reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-8/MAXIM check passed.\n\n");
+	}
+
+	// reflected table, non-zero init value
+	// CRC-8/ROHC : width=8 poly=0x07 init=0xff refin=true refout=true xorout=0x00 check=0xd0 name="CRC-8/ROHC"
+#ifdef USE_TABLE_FOR_CRC_8
+	generate_crc8_table(0x07); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_8
+	generate_crc8_nibble_table(0x07);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_8
+	if( 0xD0 != calculate_crc8((uint8_t*)"123456789",9,0xFF,0x00,0x07,1,1) )
+	{
+		printf ("CRC-8/ROHC reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-8/ROHC check passed.\n\n");
+	}
+
 	return 1; // ok.
 }
 ///////////////////////////////////////////////////////////////////		CRC8 FUNCTIONS --	///////////////////////////////////////////////////////////////////
@@ -306,6 +1679,7 @@ void generate_crc16_table(uint16_t generator_polynomial)
 	uint16_t byte_value;
 	uint8_t bit_index;
 	uint16_t crc_value;
+	uint16_t reflected_polynomial = (uint16_t)reflect(generator_polynomial,CRC_WIDTH_16);
 
 	// iterate over all byte values 0 - 255
 	for (byte_value = 0; byte_value < 256; byte_value++)
@@ -327,7 +1701,30 @@ void generate_crc16_table(uint16_t generator_polynomial)
 		}
 		/* store CRC value in lookup table */
 		crc16_table[byte_value] = crc_value;
+
+		// same again for the reflected (LSB-first) register: the byte goes into the LSB, the register shifts right,
+		// and the polynomial is bit-reversed. this is the table used for refin=true models.
+		crc_value = byte_value;
+
+		for (bit_index = 0; bit_index < 8; bit_index++)
+		{
+			if ((crc_value & 1) != 0)
+			{
+				crc_value = (crc_value >> 1) ^ reflected_polynomial;
+			}
+			else
+			{
+				crc_value >>= 1;
+			}
+		}
+		crc16_table_reflected[byte_value] = crc_value;
 	}
+
+#ifdef USE_CLMUL_FOR_CRC_16
+	// fold constants for the same polynomial, both directions.
+	generate_crc_clmul_constants(&crc16_clmul_constants, generator_polynomial, CRC_WIDTH_16, 0);
+	generate_crc_clmul_constants(&crc16_clmul_constants_reflected, generator_polynomial, CRC_WIDTH_16, 1);
+#endif // USE_CLMUL_FOR_CRC_16
 }
 #endif // #ifdef USE_TABLE_FOR_CRC_16
 
@@ -346,46 +1743,61 @@ void print_crc16_table()
 	}
 
 	printf("};\n\n");
+
+	printf("crc16_table_reflected == \n{\n");
+
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		printf("%04X,\n",crc16_table_reflected[byte_value]);
+	}
+
+	printf("};\n\n");
 }
 #endif // #ifdef USE_TABLE_FOR_CRC_16
 
 
-uint16_t calculate_crc16(	uint8_t* byte_data,
-							int32_t data_len,
-							uint16_t crc_config_initial_value,
-							uint16_t crc_config_final_xor_value,
-							uint16_t crc_config_polynomial,
-							uint8_t crc_config_reflect_input,
-							uint8_t crc_config_reflect_output )
+// runs the raw crc register over the data one bit at a time, straight from the definition: nothing precalculated.
+// the register is kept in the input direction of the model, reflected (LSB-first) for refin=true models and normal
+// (MSB-first) otherwise, so no input byte ever needs reflecting. every other engine is checked against this one.
+uint16_t update_crc16_bitwise(	uint16_t crc_config_polynomial,
+								uint16_t calculated_crc,
+								const uint8_t* byte_data,
+								size_t data_len,
+								uint8_t reflected )
 {
-	int32_t byte_data_index, bit_index;
-
-	uint16_t calculated_crc = crc_config_initial_value;
+	size_t byte_data_index;
+	uint8_t bit_index;
+	uint16_t reflected_polynomial = (uint16_t)reflect(crc_config_polynomial,CRC_WIDTH_16);
 
-	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	if(reflected == 1)
 	{
-		// xor in the next input byte, **at the MSB**
-		if(crc_config_reflect_input == 1)
-		{
-//			printf("data: 0x%02X, reflected: 0x%02X\n",byte_data[byte_data_index], reflect(byte_data[byte_data_index],8));
-			calculated_crc ^= reflect(byte_data[byte_data_index],8) << (CRC_WIDTH_16-8);
-		}
-		else
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
 		{
-			calculated_crc ^= byte_data[byte_data_index] << (CRC_WIDTH_16-8);
-		}
+			// xor in the next input byte, **at the LSB**
+			calculated_crc ^= byte_data[byte_data_index];
 
-#ifdef USE_TABLE_FOR_CRC_16
+			// calculate crc by iterating over each bit of current byte and applying the reflected polynomial.
+			for (bit_index = 0; bit_index < 8; bit_index++)
+			{
+				// if the LSbit is 1, right-shift and apply the polynomial, else just right-shift
+				if ((calculated_crc & 1) != 0)
+				{
+					calculated_crc = (calculated_crc >> 1) ^ reflected_polynomial;
+				}
+				else
+				{
+					calculated_crc >>= 1;
+				}
+			}
+		}
 
-		// http://www.sunshine2k.de/articles/coding/crc/understanding_crc.html
-		// (1)The important point is here that after xoring the current byte into the MSB of the intermediate CRC,
-		// the MSB is the index into the lookup table, so take ONLY MSB for lookup table index... this explains the crc_value >> (WIDTH-8)
-		// used for the lookup table.
-		// (2) now, as we are getting the value corresponding to MSB from the lookup table, drop the MSB from the crc
-		// i.e. shift the crc left, dropping the msb, then XOR this crc/remainder with the lookuptable value.
-		calculated_crc = (calculated_crc << 8) ^ (crc16_table[calculated_crc >> (CRC_WIDTH_16-8) ]);
+		return calculated_crc;
+	}
 
-#else
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	{
+		// xor in the next input byte, **at the MSB**
+		calculated_crc ^= byte_data[byte_data_index] << (CRC_WIDTH_16-8);
 
 		// calculate crc by iterating over each bit of current byte and applying polynomial.
 		for (bit_index = 0; bit_index < 8; bit_index++)
@@ -401,101 +1813,78 @@ uint16_t calculate_crc16(	uint8_t* byte_data,
 			}
 		}
 
-#endif // USE_TABLE_FOR_CRC_16
-
 		// at this point, we have the calculated crc upto the current byte.
 	}
 
-	// xor with final_xor_value:
-	if(crc_config_reflect_output == 1)
-	{
-		calculated_crc = (reflect(calculated_crc,CRC_WIDTH_16) & CRC_MASK(CRC_WIDTH_16)) ^ crc_config_final_xor_value;
-	}
-	else
-	{
-		calculated_crc ^= crc_config_final_xor_value;
-	}
-
-//	printf("calculated_crc_16 = 0x%04X\n",calculated_crc);
-
 	return calculated_crc;
 }
 
 
-int check_crc_16_algo()
-{
-	// simple 1
-	// CRC-16/AUG-CCITT : width=16 poly=0x1021 init=0x1d0f refin=false refout=false xorout=0x0000 check=0xe5cc name="CRC-16/AUG-CCITT"
 #ifdef USE_TABLE_FOR_CRC_16
-	generate_crc16_table(0x1021); // required if testing table based implementation.
-#endif // USE_TABLE_FOR_CRC_8
-	if( 0xE5CC != calculate_crc16((uint8_t*)"123456789",9,0x1D0F,0x0000,0x1021,0,0) )
-	{
-		printf ("CRC-16/AUG-CCITT reference check failed!\n\n");
-		return -1;
-	}
-	else
+// same as update_crc16_bitwise(), one table lookup per byte. the table has to match the register direction,
+// i.e. crc16_table or crc16_table_reflected as built by generate_crc16_table(), or a registry table.
+uint16_t update_crc16_table(	const uint16_t* table,
+							uint16_t calculated_crc,
+							const uint8_t* byte_data,
+							size_t data_len,
+							uint8_t reflected )
+{
+	size_t byte_data_index;
+
+	if(reflected == 1)
 	{
-//		printf ("CRC-16/AUG-CCITT check passed.\n\n");
-	}
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+		{
+			// xor in the next input byte, **at the LSB**
+			calculated_crc ^= byte_data[byte_data_index];
 
+			// mirror image of the normal table step: the LSB is the index into the reflected table,
+			// drop it by shifting the crc right, then XOR in the lookuptable value.
+			calculated_crc = (calculated_crc >> 8) ^ (table[calculated_crc & 0xFF]);
+		}
 
-	// simple 2
-	// CRC-16/CCITT-FALSE: width=16 poly=0x1021 init=0xffff refin=false refout=false xorout=0x0000 check=0x29b1 name="CRC-16/CCITT-FALSE"
-#ifdef USE_TABLE_FOR_CRC_16
-	generate_crc16_table(0x1021); // required if testing table based implementation.
-#endif // USE_TABLE_FOR_CRC_8
-	if( 0x29B1 != calculate_crc16((uint8_t*)"123456789",9,0xFFFF,0x0000,0x1021,0,0) )
-	{
-		printf ("CRC-16/CCITT-FALSE reference check failed!\n\n");
-		return -1;
+		return calculated_crc;
 	}
-	else
+
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
 	{
-//		printf ("CRC-16/CCITT-FALSE check passed.\n\n");
-	}
+		// xor in the next input byte, **at the MSB**
+		calculated_crc ^= byte_data[byte_data_index] << (CRC_WIDTH_16-8);
 
+		// http://www.sunshine2k.de/articles/coding/crc/understanding_crc.html
+		// (1)The important point is here that after xoring the current byte into the MSB of the intermediate CRC,
+		// the MSB is the index into the lookup table, so take ONLY MSB for lookup table index... this explains the crc_value >> (WIDTH-8)
+		// used for the lookup table.
+		// (2) now, as we are getting the value corresponding to MSB from the lookup table, drop the MSB from the crc
+		// i.e. shift the crc left, dropping the msb, then XOR this crc/remainder with the lookuptable value.
+		calculated_crc = (calculated_crc << 8) ^ (table[calculated_crc >> (CRC_WIDTH_16-8) ]);
 
-	// reflect input and reflect crc
-	// ARC : width=16 poly=0x8005 init=0x0000 refin=true refout=true xorout=0x0000 check=0xbb3d name="ARC"
-#ifdef USE_TABLE_FOR_CRC_16
-	generate_crc16_table(0x8005); // required if testing table based implementation.
-#endif // USE_TABLE_FOR_CRC_8
-	if( 0xBB3D != calculate_crc16((uint8_t*)"123456789",9,0x0000,0x0000,0x8005,1,1) )
-	{
-		printf ("ARC reference check failed!\n\n");
-		return -1;
-	}
-	else
-	{
-//		printf ("ARC check passed.\n\n");
+		// at this point, we have the calculated crc upto the current byte.
 	}
 
-
-	return 1; // ok.
+	return calculated_crc;
 }
-///////////////////////////////////////////////////////////////////		CRC16 FUNCTIONS --	///////////////////////////////////////////////////////////////////
-
+#endif // #ifdef USE_TABLE_FOR_CRC_16
 
 
-///////////////////////////////////////////////////////////////////		CRC32 FUNCTIONS ++	///////////////////////////////////////////////////////////////////
-#ifdef USE_TABLE_FOR_CRC_32
-void generate_crc32_table(uint32_t generator_polynomial)
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+// 16 entry tables for update_crc16_nibble(): the register after 4 shift steps, starting from each nibble value at the
+// end of the register the data goes in at. both directions, like generate_crc16_table().
+void generate_crc16_nibble_table(uint16_t generator_polynomial)
 {
-	uint16_t byte_value;
+	uint8_t nibble_value;
 	uint8_t bit_index;
-	uint32_t crc_value;
+	uint16_t crc_value;
+	uint16_t reflected_polynomial = (uint16_t)reflect(generator_polynomial,CRC_WIDTH_16);
 
-	// iterate over all byte values 0 - 255
-	for (byte_value = 0; byte_value < 256; byte_value++)
+	// iterate over all nibble values 0 - 15
+	for (nibble_value = 0; nibble_value < 16; nibble_value++)
 	{
-		// calculate the CRC-8 value for current byte
-
-		crc_value = byte_value << (CRC_WIDTH_32 - 8); // move byte into MSB of 32Bit CRC
+		crc_value = (uint16_t)nibble_value << (CRC_WIDTH_16 - 4); // move nibble into the top 4 bits of the register
 
-		for (bit_index = 0; bit_index < 8; bit_index++)
+		for (bit_index = 0; bit_index < 4; bit_index++)
 		{
-			if ((crc_value & TOPBIT(CRC_WIDTH_32)) != 0)
+			if ((crc_value & TOPBIT(CRC_WIDTH_16)) != 0)
 			{
 				crc_value = (crc_value << 1) ^ generator_polynomial;
 			}
@@ -504,168 +1893,6970 @@ void generate_crc32_table(uint32_t generator_polynomial)
 				crc_value <<= 1;
 			}
 		}
-		/* store CRC value in lookup table */
-		crc32_table[byte_value] = crc_value;
+		crc16_nibble_table[nibble_value] = crc_value;
+
+		// reflected (LSB-first) register: the nibble goes into the low 4 bits, the register shifts right.
+		crc_value = nibble_value;
+
+		for (bit_index = 0; bit_index < 4; bit_index++)
+		{
+			if ((crc_value & 1) != 0)
+			{
+				crc_value = (crc_value >> 1) ^ reflected_polynomial;
+			}
+			else
+			{
+				crc_value >>= 1;
+			}
+		}
+		crc16_nibble_table_reflected[nibble_value] = crc_value;
 	}
 }
-#endif // #ifdef USE_TABLE_FOR_CRC_32
 
 
-#ifdef USE_TABLE_FOR_CRC_32
-void print_crc32_table()
+// same as update_crc32_nibble(), 16 bit register.
+uint16_t update_crc16_nibble(	const uint16_t* table,
+							uint16_t calculated_crc,
+							const uint8_t* byte_data,
+							size_t data_len,
+							uint8_t reflected )
 {
-	uint16_t byte_value;
+	size_t byte_data_index;
 
-	printf("crc32_table == \n{\n");
+	if(reflected == 1)
+	{
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+		{
+			calculated_crc ^= byte_data[byte_data_index];
+			calculated_crc = (calculated_crc >> 4) ^ table[calculated_crc & 0x0F];
+			calculated_crc = (calculated_crc >> 4) ^ table[calculated_crc & 0x0F];
+		}
 
-	// iterate over all byte values 0 - 255
-	for (byte_value = 0; byte_value < 256; byte_value++)
+		return calculated_crc;
+	}
+
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
 	{
-		printf("%08X,\n",crc32_table[byte_value]);
+		calculated_crc ^= byte_data[byte_data_index] << (CRC_WIDTH_16-8);
+		calculated_crc = (calculated_crc << 4) ^ table[calculated_crc >> (CRC_WIDTH_16-4)];
+		calculated_crc = (calculated_crc << 4) ^ table[calculated_crc >> (CRC_WIDTH_16-4)];
 	}
 
-	printf("};\n\n");
+	return calculated_crc;
+}
+#endif // #ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+
+
+uint16_t calculate_crc16(	uint8_t* byte_data,
+						int32_t data_len,
+						uint16_t crc_config_initial_value,
+						uint16_t crc_config_final_xor_value,
+						uint16_t crc_config_polynomial,
+						uint8_t crc_config_reflect_input,
+						uint8_t crc_config_reflect_output )
+{
+	// refin=true models are run natively on a reflected (LSB-first) register, instead of reflecting every input byte
+	// and then the whole crc again at the end. the register, the polynomial and the table are all bit-reversed,
+	// so the input byte goes in at the LSB untouched and the register shifts right.
+	uint8_t reflected = (crc_config_reflect_input == 1);
+	size_t remaining_len = (data_len > 0) ? (size_t)data_len : 0;
+	uint16_t calculated_crc = reflected ? (uint16_t)reflect(crc_config_initial_value,CRC_WIDTH_16) : crc_config_initial_value;
+
+#ifdef USE_CLMUL_FOR_CRC_16
+	// fold the bulk with PCLMULQDQ, the table below finishes the last (data_len % 16) bytes.
+	if(remaining_len >= CRC_CLMUL_MIN_LEN && crc_clmul_available())
+	{
+		calculated_crc = (uint16_t)update_crc_clmul(reflected ? &crc16_clmul_constants_reflected : &crc16_clmul_constants,calculated_crc,byte_data,remaining_len & ~(size_t)15);
+		byte_data += remaining_len & ~(size_t)15;
+		remaining_len &= 15;
+	}
+#endif // USE_CLMUL_FOR_CRC_16
+
+#ifdef USE_TABLE_FOR_CRC_16
+	calculated_crc = update_crc16_table(reflected ? crc16_table_reflected : crc16_table,calculated_crc,byte_data,remaining_len,reflected);
+#elif defined(USE_NIBBLE_TABLE_FOR_CRC_16)
+	calculated_crc = update_crc16_nibble(reflected ? crc16_nibble_table_reflected : crc16_nibble_table,calculated_crc,byte_data,remaining_len,reflected);
+#else
+	calculated_crc = update_crc16_bitwise(crc_config_polynomial,calculated_crc,byte_data,remaining_len,reflected);
+#endif // USE_TABLE_FOR_CRC_16
+
+	// the register is in the input direction, it only needs reflecting if the output direction is different.
+	if(reflected != (crc_config_reflect_output == 1))
+	{
+		calculated_crc = (reflect(calculated_crc,CRC_WIDTH_16) & CRC_MASK(CRC_WIDTH_16));
+	}
+
+	// xor with final_xor_value:
+	calculated_crc ^= crc_config_final_xor_value;
+
+//	printf("calculated_crc_16 = 0x%04X\n",calculated_crc);
+
+	return calculated_crc;
+}
+
+
+#ifdef USE_SLICING_FOR_CRC_16
+void generate_crc16_slicing_tables(uint16_t generator_polynomial)
+{
+	uint16_t byte_value;
+	uint8_t slice_index;
+
+	// slice 0 is the plain byte table, for both directions.
+	generate_crc16_table(generator_polynomial);
+
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		crc16_slicing_table[0][byte_value] = crc16_table[byte_value];
+		crc16_slicing_table_reflected[0][byte_value] = crc16_table_reflected[byte_value];
+	}
+
+	// every next slice pushes one more zero byte through the register: one more byte table step on the previous slice.
+	for (slice_index = 1; slice_index < CRC_SLICES_MAX; slice_index++)
+	{
+		for (byte_value = 0; byte_value < 256; byte_value++)
+		{
+			uint16_t crc_value = crc16_slicing_table[slice_index-1][byte_value];
+			crc16_slicing_table[slice_index][byte_value] = (crc_value << 8) ^ crc16_table[crc_value >> (CRC_WIDTH_16-8)];
+
+			crc_value = crc16_slicing_table_reflected[slice_index-1][byte_value];
+			crc16_slicing_table_reflected[slice_index][byte_value] = (crc_value >> 8) ^ crc16_table_reflected[crc_value & 0xFF];
+		}
+	}
+}
+
+
+// runs the raw (reflected, LSB-first) register over the data, 'slices' bytes per iteration.
+// the first 2 bytes of each block are xored into the register, the rest are looked up as-is;
+// byte i of the block goes through table[slices-1-i], i.e. the table that accounts for the bytes still following it.
+static inline uint16_t update_crc16_slicing_reflected(const uint16_t (*slicing_table)[256], uint16_t calculated_crc, const uint8_t* byte_data, size_t data_len, const uint8_t slices)
+{
+	uint8_t byte_index;
+	uint16_t next_crc;
+
+	while (slices >= CRC_SLICES_4 && data_len >= slices)
+	{
+		calculated_crc ^= (uint16_t)(byte_data[0] | (byte_data[1] << 8));
+
+		next_crc =	slicing_table[slices-1][calculated_crc & 0xFF] ^
+					slicing_table[slices-2][calculated_crc >> 8];
+
+#if defined(__GNUC__)
+#pragma GCC unroll 16
+#endif // __GNUC__
+		for (byte_index = 2; byte_index < slices; byte_index++)
+		{
+			next_crc ^= slicing_table[slices-1-byte_index][byte_data[byte_index]];
+		}
+
+		calculated_crc = next_crc;
+		byte_data += slices;
+		data_len -= slices;
+	}
+
+	// tail, byte by byte.
+	while (data_len-- > 0)
+	{
+		calculated_crc = (calculated_crc >> 8) ^ slicing_table[0][(calculated_crc ^ *byte_data++) & 0xFF];
+	}
+
+	return calculated_crc;
+}
+
+
+// same thing for the normal (MSB-first) register, the block is read big-endian so its first byte lines up with the MSB.
+static inline uint16_t update_crc16_slicing(const uint16_t (*slicing_table)[256], uint16_t calculated_crc, const uint8_t* byte_data, size_t data_len, const uint8_t slices)
+{
+	uint8_t byte_index;
+	uint16_t next_crc;
+
+	while (slices >= CRC_SLICES_4 && data_len >= slices)
+	{
+		calculated_crc ^= (uint16_t)((byte_data[0] << 8) | byte_data[1]);
+
+		next_crc =	slicing_table[slices-1][calculated_crc >> 8] ^
+					slicing_table[slices-2][calculated_crc & 0xFF];
+
+#if defined(__GNUC__)
+#pragma GCC unroll 16
+#endif // __GNUC__
+		for (byte_index = 2; byte_index < slices; byte_index++)
+		{
+			next_crc ^= slicing_table[slices-1-byte_index][byte_data[byte_index]];
+		}
+
+		calculated_crc = next_crc;
+		byte_data += slices;
+		data_len -= slices;
+	}
+
+	// tail, byte by byte.
+	while (data_len-- > 0)
+	{
+		calculated_crc = (calculated_crc << 8) ^ slicing_table[0][(calculated_crc >> (CRC_WIDTH_16-8)) ^ *byte_data++];
+	}
+
+	return calculated_crc;
+}
+
+
+// runs the raw register (in the given direction) over the data with slicing-by-N, slices is one of CRC_SLICES_4/8/16,
+// anything else runs the byte table (slice 0). the slicing tables have to match the direction.
+uint16_t update_crc16_sliced(	const uint16_t (*slicing_table)[256],
+							uint16_t calculated_crc,
+							const uint8_t* byte_data,
+							size_t data_len,
+							uint8_t slices,
+							uint8_t reflected )
+{
+	// the slice count is passed as a constant so each case gets its own fully unrolled loop.
+	if(reflected == 1)
+	{
+		switch(slices)
+		{
+			case CRC_SLICES_16:	return update_crc16_slicing_reflected(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_16);
+			case CRC_SLICES_8:	return update_crc16_slicing_reflected(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_8);
+			case CRC_SLICES_4:	return update_crc16_slicing_reflected(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_4);
+			default:			return update_crc16_slicing_reflected(slicing_table,calculated_crc,byte_data,data_len,1);
+		}
+	}
+
+	switch(slices)
+	{
+		case CRC_SLICES_16:	return update_crc16_slicing(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_16);
+		case CRC_SLICES_8:	return update_crc16_slicing(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_8);
+		case CRC_SLICES_4:	return update_crc16_slicing(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_4);
+		default:			return update_crc16_slicing(slicing_table,calculated_crc,byte_data,data_len,1);
+	}
+}
+
+
+// slicing-by-N version of calculate_crc16(), crc_config_slices is one of CRC_SLICES_4/8/16 (anything else runs
+// the byte table). needs generate_crc16_slicing_tables() for the polynomial first, just like the plain table version.
+uint16_t calculate_crc16_slicing(	uint8_t* byte_data,
+									int32_t data_len,
+									uint16_t crc_config_initial_value,
+									uint16_t crc_config_final_xor_value,
+									uint16_t crc_config_polynomial,
+									uint8_t crc_config_reflect_input,
+									uint8_t crc_config_reflect_output,
+									uint8_t crc_config_slices )
+{
+	uint8_t reflected = (crc_config_reflect_input == 1);
+	uint16_t calculated_crc = reflected ? (uint16_t)reflect(crc_config_initial_value,CRC_WIDTH_16) : crc_config_initial_value;
+
+	(void)crc_config_polynomial; // baked into the tables.
+
+	calculated_crc = update_crc16_sliced(	reflected ? crc16_slicing_table_reflected : crc16_slicing_table,
+											calculated_crc,byte_data,(data_len > 0) ? (size_t)data_len : 0,crc_config_slices,reflected);
+
+	if(reflected != (crc_config_reflect_output == 1))
+	{
+		calculated_crc = (reflect(calculated_crc,CRC_WIDTH_16) & CRC_MASK(CRC_WIDTH_16));
+	}
+
+	return calculated_crc ^ crc_config_final_xor_value;
+}
+
+
+// cross-check of the slicing engines against calculate_crc16() (byte table), over a buffer long enough to
+// run the sliced loop several times, for every slice count, at odd lengths and unaligned start offsets.
+int check_crc16_slicing_engine(uint16_t crc_config_initial_value,
+								uint16_t crc_config_final_xor_value,
+								uint16_t crc_config_polynomial,
+								uint8_t crc_config_reflect_input,
+								uint8_t crc_config_reflect_output )
+{
+	static const uint8_t slice_counts [3] = {CRC_SLICES_4, CRC_SLICES_8, CRC_SLICES_16};
+	uint8_t data_array [1031];
+	int32_t data_len, data_offset;
+	uint8_t slice_index;
+	uint16_t expected_crc;
+
+	fill_crc_test_data(data_array, sizeof(data_array), 0x12345678);
+
+	generate_crc16_slicing_tables(crc_config_polynomial);
+
+	for (data_offset = 0; data_offset < 4; data_offset++)
+	{
+		for (data_len = 0; data_len < (int32_t)sizeof(data_array) - data_offset; data_len += 37)
+		{
+			expected_crc = calculate_crc16(data_array + data_offset,data_len,crc_config_initial_value,crc_config_final_xor_value,crc_config_polynomial,crc_config_reflect_input,crc_config_reflect_output);
+
+			for (slice_index = 0; slice_index < sizeof(slice_counts); slice_index++)
+			{
+				if( expected_crc != calculate_crc16_slicing(data_array + data_offset,data_len,crc_config_initial_value,crc_config_final_xor_value,crc_config_polynomial,crc_config_reflect_input,crc_config_reflect_output,slice_counts[slice_index]) )
+				{
+					printf("slicing-by-%d mismatch, poly 0x%04X, len %d, offset %d\n",slice_counts[slice_index],crc_config_polynomial,data_len,data_offset);
+					return -1;
+				}
+			}
+		}
+	}
+
+	return 1; // ok.
+}
+#endif // #ifdef USE_SLICING_FOR_CRC_16
+
+
+int check_crc_16_algo()
+{
+	// simple 1
+	// CRC-16/AUG-CCITT : width=16 poly=0x1021 init=0x1d0f refin=false refout=false xorout=0x0000 check=0xe5cc name="CRC-16/AUG-CCITT"
+#ifdef USE_TABLE_FOR_CRC_16
+	generate_crc16_table(0x1021); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+	generate_crc16_nibble_table(0x1021);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_16
+	if( 0xE5CC != calculate_crc16((uint8_t*)"123456789",9,0x1D0F,0x0000,0x1021,0,0) )
+	{
+		printf ("CRC-16/AUG-CCITT reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-16/AUG-CCITT check passed.\n\n");
+	}
+
+
+	// simple 2
+	// CRC-16/CCITT-FALSE: width=16 poly=0x1021 init=0xffff refin=false refout=false xorout=0x0000 check=0x29b1 name="CRC-16/CCITT-FALSE"
+#ifdef USE_TABLE_FOR_CRC_16
+	generate_crc16_table(0x1021); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+	generate_crc16_nibble_table(0x1021);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_16
+	if( 0x29B1 != calculate_crc16((uint8_t*)"123456789",9,0xFFFF,0x0000,0x1021,0,0) )
+	{
+		printf ("CRC-16/CCITT-FALSE reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-16/CCITT-FALSE check passed.\n\n");
+	}
+
+
+	// reflect input and reflect crc
+	// ARC : width=16 poly=0x8005 init=0x0000 refin=true refout=true xorout=0x0000 check=0xbb3d name="ARC"
+#ifdef USE_TABLE_FOR_CRC_16
+	generate_crc16_table(0x8005); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+	generate_crc16_nibble_table(0x8005);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_16
+	if( 0xBB3D != calculate_crc16((uint8_t*)"123456789",9,0x0000,0x0000,0x8005,1,1) )
+	{
+		printf ("ARC reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("ARC check passed.\n\n");
+	}
+
+
+	// reflect input and reflect crc, non-zero init value
+	// CRC-16/MODBUS : width=16 poly=0x8005 init=0xffff refin=true refout=true xorout=0x0000 check=0x4b37 name="MODBUS"
+#ifdef USE_TABLE_FOR_CRC_16
+	generate_crc16_table(0x8005); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_16
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+	generate_crc16_nibble_table(0x8005);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_16
+	if( 0x4B37 != calculate_crc16((uint8_t*)"123456789",9,0xFFFF,0x0000,0x8005,1,1) )
+	{
+		printf ("CRC-16/MODBUS reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-16/MODBUS check passed.\n\n");
+	}
+
+	// reflect input and reflect crc, with xor-out value
+	// CRC-16/X-25 : width=16 poly=0x1021 init=0xffff refin=true refout=true xorout=0xffff check=0x906e name="X-25"
+#ifdef USE_TABLE_FOR_CRC_16
+	generate_crc16_table(0x1021); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_16
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+	generate_crc16_nibble_table(0x1021);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_16
+	if( 0x906E != calculate_crc16((uint8_t*)"123456789",9,0xFFFF,0xFFFF,0x1021,1,1) )
+	{
+		printf ("CRC-16/X-25 reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-16/X-25 check passed.\n\n");
+	}
+
+	// no reflection, all zero init and xor-out, same polynomial as X-25 in the other direction
+	// CRC-16/XMODEM : width=16 poly=0x1021 init=0x0000 refin=false refout=false xorout=0x0000 check=0x31c3 name="XMODEM"
+#ifdef USE_TABLE_FOR_CRC_16
+	generate_crc16_table(0x1021); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_16
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+	generate_crc16_nibble_table(0x1021);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_16
+	if( 0x31C3 != calculate_crc16((uint8_t*)"123456789",9,0x0000,0x0000,0x1021,0,0) )
+	{
+		printf ("CRC-16/XMODEM reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-16/XMODEM check passed.\n\n");
+	}
+
+
+#ifdef USE_SLICING_FOR_CRC_16
+	// slicing-by-4/8/16 against the byte table, both register directions.
+	if( check_crc16_slicing_engine(0x0000,0x0000,0x8005,1,1) != 1 )
+	{
+		printf ("ARC slicing check failed!\n\n");
+		return -1;
+	}
+	if( check_crc16_slicing_engine(0xFFFF,0x0000,0x1021,0,0) != 1 )
+	{
+		printf ("CRC-16/CCITT-FALSE slicing check failed!\n\n");
+		return -1;
+	}
+	if( check_crc16_slicing_engine(0xFFFF,0xFFFF,0x1021,1,1) != 1 )
+	{
+		printf ("X-25 slicing check failed!\n\n");
+		return -1;
+	}
+#endif // USE_SLICING_FOR_CRC_16
+
+
+	return 1; // ok.
+}
+///////////////////////////////////////////////////////////////////		CRC16 FUNCTIONS --	///////////////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////		CRC32 FUNCTIONS ++	///////////////////////////////////////////////////////////////////
+#ifdef USE_TABLE_FOR_CRC_32
+void generate_crc32_table(uint32_t generator_polynomial)
+{
+	uint16_t byte_value;
+	uint8_t bit_index;
+	uint32_t crc_value;
+	uint32_t reflected_polynomial = (uint32_t)reflect(generator_polynomial,CRC_WIDTH_32);
+
+	// iterate over all byte values 0 - 255
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		// calculate the CRC-8 value for current byte
+
+		crc_value = byte_value << (CRC_WIDTH_32 - 8); // move byte into MSB of 32Bit CRC
+
+		for (bit_index = 0; bit_index < 8; bit_index++)
+		{
+			if ((crc_value & TOPBIT(CRC_WIDTH_32)) != 0)
+			{
+				crc_value = (crc_value << 1) ^ generator_polynomial;
+			}
+			else
+			{
+				crc_value <<= 1;
+			}
+		}
+		/* store CRC value in lookup table */
+		crc32_table[byte_value] = crc_value;
+
+		// same again for the reflected (LSB-first) register: the byte goes into the LSB, the register shifts right,
+		// and the polynomial is bit-reversed. this is the table used for refin=true models.
+		crc_value = byte_value;
+
+		for (bit_index = 0; bit_index < 8; bit_index++)
+		{
+			if ((crc_value & 1) != 0)
+			{
+				crc_value = (crc_value >> 1) ^ reflected_polynomial;
+			}
+			else
+			{
+				crc_value >>= 1;
+			}
+		}
+		crc32_table_reflected[byte_value] = crc_value;
+	}
+
+#ifdef USE_CLMUL_FOR_CRC_32
+	// fold constants for the same polynomial, both directions.
+	generate_crc_clmul_constants(&crc32_clmul_constants, generator_polynomial, CRC_WIDTH_32, 0);
+	generate_crc_clmul_constants(&crc32_clmul_constants_reflected, generator_polynomial, CRC_WIDTH_32, 1);
+#endif // USE_CLMUL_FOR_CRC_32
+}
+#endif // #ifdef USE_TABLE_FOR_CRC_32
+
+
+#ifdef USE_TABLE_FOR_CRC_32
+void print_crc32_table()
+{
+	uint16_t byte_value;
+
+	printf("crc32_table == \n{\n");
+
+	// iterate over all byte values 0 - 255
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		printf("%08X,\n",crc32_table[byte_value]);
+	}
+
+	printf("};\n\n");
+
+	printf("crc32_table_reflected == \n{\n");
+
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		printf("%08X,\n",crc32_table_reflected[byte_value]);
+	}
+
+	printf("};\n\n");
+}
+#endif // #ifdef USE_TABLE_FOR_CRC_32
+
+
+#ifdef USE_HW_FOR_CRC_32C
+int crc32c_hw_available()
+{
+	return __builtin_cpu_supports("sse4.2");
+}
+
+
+// moves a (reflected, raw) crc32c register over 'block' zero bytes, i.e. crc * x^(8*block) mod P.
+// the carry-less product of the register and the constant is fed through the crc32 instruction, which multiplies
+// by another x^32 and reduces mod P. the reflected product is one bit short (x^63 is bit 0), which is another x^1,
+// hence the x^(8*block-33) in the constants.
+__attribute__((target("sse4.2,pclmul")))
+static inline uint32_t shift_crc32c_hw(uint32_t calculated_crc, uint32_t shift_constant)
+{
+	__m128i product = _mm_clmulepi64_si128(_mm_cvtsi32_si128(calculated_crc), _mm_cvtsi32_si128(shift_constant), 0x00);
+
+	return (uint32_t)_mm_crc32_u64(0, (uint64_t)_mm_cvtsi128_si64(product));
+}
+
+
+// one stream, 8 bytes per instruction. used for the tail, and on its own if the cpu has no PCLMULQDQ for the merges.
+__attribute__((target("sse4.2")))
+static uint32_t update_crc32c_hw_single(uint32_t calculated_crc, const uint8_t* byte_data, size_t data_len)
+{
+	uint64_t data_word;
+	uint64_t running_crc;
+
+	// byte steps up to an 8 byte boundary.
+	while (data_len > 0 && ((uintptr_t)byte_data & 7) != 0)
+	{
+		calculated_crc = _mm_crc32_u8(calculated_crc, *byte_data++);
+		data_len--;
+	}
+
+	running_crc = calculated_crc;
+	while (data_len >= 8)
+	{
+		memcpy(&data_word, byte_data, 8);
+		running_crc = _mm_crc32_u64(running_crc, data_word);
+		byte_data += 8;
+		data_len -= 8;
+	}
+	calculated_crc = (uint32_t)running_crc;
+
+	while (data_len-- > 0)
+	{
+		calculated_crc = _mm_crc32_u8(calculated_crc, *byte_data++);
+	}
+
+	return calculated_crc;
+}
+
+
+// 3 blocks of 'block' bytes each, one stream per block, then merged: ((crc0 << block) ^ crc1) << block) ^ crc2.
+__attribute__((target("sse4.2,pclmul")))
+static inline uint32_t update_crc32c_hw_3way_block(uint32_t calculated_crc, const uint8_t* byte_data, const int32_t block, uint32_t shift_constant)
+{
+	uint64_t crc0 = calculated_crc, crc1 = 0, crc2 = 0;
+	uint64_t data_word0, data_word1, data_word2;
+	const uint8_t* block_end = byte_data + block;
+
+	do
+	{
+		memcpy(&data_word0, byte_data, 8);
+		memcpy(&data_word1, byte_data + block, 8);
+		memcpy(&data_word2, byte_data + 2*block, 8);
+		crc0 = _mm_crc32_u64(crc0, data_word0);
+		crc1 = _mm_crc32_u64(crc1, data_word1);
+		crc2 = _mm_crc32_u64(crc2, data_word2);
+		byte_data += 8;
+	} while (byte_data < block_end);
+
+	calculated_crc = shift_crc32c_hw((uint32_t)crc0, shift_constant) ^ (uint32_t)crc1;
+	calculated_crc = shift_crc32c_hw(calculated_crc, shift_constant) ^ (uint32_t)crc2;
+
+	return calculated_crc;
+}
+
+
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t update_crc32c_hw_3way(uint32_t calculated_crc, const uint8_t* byte_data, size_t data_len)
+{
+	// byte steps up to an 8 byte boundary.
+	while (data_len > 0 && ((uintptr_t)byte_data & 7) != 0)
+	{
+		calculated_crc = _mm_crc32_u8(calculated_crc, *byte_data++);
+		data_len--;
+	}
+
+	while (data_len >= 3*CRC_32C_HW_LONG_BLOCK)
+	{
+		calculated_crc = update_crc32c_hw_3way_block(calculated_crc, byte_data, CRC_32C_HW_LONG_BLOCK, CRC_32C_HW_LONG_SHIFT);
+		byte_data += 3*CRC_32C_HW_LONG_BLOCK;
+		data_len -= 3*CRC_32C_HW_LONG_BLOCK;
+	}
+
+	while (data_len >= 3*CRC_32C_HW_SHORT_BLOCK)
+	{
+		calculated_crc = update_crc32c_hw_3way_block(calculated_crc, byte_data, CRC_32C_HW_SHORT_BLOCK, CRC_32C_HW_SHORT_SHIFT);
+		byte_data += 3*CRC_32C_HW_SHORT_BLOCK;
+		data_len -= 3*CRC_32C_HW_SHORT_BLOCK;
+	}
+
+	return update_crc32c_hw_single(calculated_crc, byte_data, data_len);
+}
+
+
+// runs the raw (reflected) crc32c register over the data. the caller checks crc32c_hw_available() first.
+uint32_t update_crc32c_hw(uint32_t calculated_crc, const uint8_t* byte_data, size_t data_len)
+{
+	if (__builtin_cpu_supports("pclmul"))
+	{
+		return update_crc32c_hw_3way(calculated_crc, byte_data, data_len);
+	}
+
+	return update_crc32c_hw_single(calculated_crc, byte_data, data_len);
+}
+#endif // #ifdef USE_HW_FOR_CRC_32C
+
+
+// runs the raw crc register over the data one bit at a time, straight from the definition: nothing precalculated.
+// the register is kept in the input direction of the model, reflected (LSB-first) for refin=true models and normal
+// (MSB-first) otherwise, so no input byte ever needs reflecting. every other engine is checked against this one.
+uint32_t update_crc32_bitwise(	uint32_t crc_config_polynomial,
+								uint32_t calculated_crc,
+								const uint8_t* byte_data,
+								size_t data_len,
+								uint8_t reflected )
+{
+	size_t byte_data_index;
+	uint8_t bit_index;
+	uint32_t reflected_polynomial = (uint32_t)reflect(crc_config_polynomial,CRC_WIDTH_32);
+
+	if(reflected == 1)
+	{
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+		{
+			// xor in the next input byte, **at the LSB**
+			calculated_crc ^= byte_data[byte_data_index];
+
+			// calculate crc by iterating over each bit of current byte and applying the reflected polynomial.
+			for (bit_index = 0; bit_index < 8; bit_index++)
+			{
+				// if the LSbit is 1, right-shift and apply the polynomial, else just right-shift
+				if ((calculated_crc & 1) != 0)
+				{
+					calculated_crc = (calculated_crc >> 1) ^ reflected_polynomial;
+				}
+				else
+				{
+					calculated_crc >>= 1;
+				}
+			}
+		}
+
+		return calculated_crc;
+	}
+
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	{
+		// xor in the next input byte, **at the MSB**
+		calculated_crc ^= (uint32_t)byte_data[byte_data_index] << (CRC_WIDTH_32-8);
+
+		// calculate crc by iterating over each bit of current byte and applying polynomial.
+		for (bit_index = 0; bit_index < 8; bit_index++)
+		{
+			// if the MSbit is 1, left-shift and apply the polynomial, else just left-shift
+			if ((calculated_crc & TOPBIT(CRC_WIDTH_32)) != 0)
+			{
+				calculated_crc = ( ( (calculated_crc << 1) ^ crc_config_polynomial ) & CRC_MASK(CRC_WIDTH_32) );
+			}
+			else
+			{
+				calculated_crc <<= 1;
+			}
+		}
+
+		// at this point, we have the calculated crc upto the current byte.
+	}
+
+	return calculated_crc;
+}
+
+
+#ifdef USE_TABLE_FOR_CRC_32
+// same as update_crc32_bitwise(), one table lookup per byte. the table has to match the register direction,
+// i.e. crc32_table or crc32_table_reflected as built by generate_crc32_table(), or a registry table.
+uint32_t update_crc32_table(	const uint32_t* table,
+							uint32_t calculated_crc,
+							const uint8_t* byte_data,
+							size_t data_len,
+							uint8_t reflected )
+{
+	size_t byte_data_index;
+
+	if(reflected == 1)
+	{
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+		{
+			// xor in the next input byte, **at the LSB**
+			calculated_crc ^= byte_data[byte_data_index];
+
+			// mirror image of the normal table step: the LSB is the index into the reflected table,
+			// drop it by shifting the crc right, then XOR in the lookuptable value.
+			calculated_crc = (calculated_crc >> 8) ^ (table[calculated_crc & 0xFF]);
+		}
+
+		return calculated_crc;
+	}
+
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	{
+		// xor in the next input byte, **at the MSB**
+		calculated_crc ^= (uint32_t)byte_data[byte_data_index] << (CRC_WIDTH_32-8);
+
+		// http://www.sunshine2k.de/articles/coding/crc/understanding_crc.html
+		// (1)The important point is here that after xoring the current byte into the MSB of the intermediate CRC,
+		// the MSB is the index into the lookup table, so take ONLY MSB for lookup table index... this explains the crc_value >> (WIDTH-8)
+		// used for the lookup table.
+		// (2) now, as we are getting the value corresponding to MSB from the lookup table, drop the MSB from the crc
+		// i.e. shift the crc left, dropping the msb, then XOR this crc/remainder with the lookuptable value.
+		calculated_crc = (calculated_crc << 8) ^ (table[calculated_crc >> (CRC_WIDTH_32-8) ]);
+
+		// at this point, we have the calculated crc upto the current byte.
+	}
+
+	return calculated_crc;
+}
+#endif // #ifdef USE_TABLE_FOR_CRC_32
+
+
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+// 16 entry tables for update_crc32_nibble(): the register after 4 shift steps, starting from each nibble value at the
+// end of the register the data goes in at. both directions, like generate_crc32_table().
+void generate_crc32_nibble_table(uint32_t generator_polynomial)
+{
+	uint8_t nibble_value;
+	uint8_t bit_index;
+	uint32_t crc_value;
+	uint32_t reflected_polynomial = (uint32_t)reflect(generator_polynomial,CRC_WIDTH_32);
+
+	// iterate over all nibble values 0 - 15
+	for (nibble_value = 0; nibble_value < 16; nibble_value++)
+	{
+		crc_value = (uint32_t)nibble_value << (CRC_WIDTH_32 - 4); // move nibble into the top 4 bits of the register
+
+		for (bit_index = 0; bit_index < 4; bit_index++)
+		{
+			if ((crc_value & TOPBIT(CRC_WIDTH_32)) != 0)
+			{
+				crc_value = (crc_value << 1) ^ generator_polynomial;
+			}
+			else
+			{
+				crc_value <<= 1;
+			}
+		}
+		crc32_nibble_table[nibble_value] = crc_value;
+
+		// reflected (LSB-first) register: the nibble goes into the low 4 bits, the register shifts right.
+		crc_value = nibble_value;
+
+		for (bit_index = 0; bit_index < 4; bit_index++)
+		{
+			if ((crc_value & 1) != 0)
+			{
+				crc_value = (crc_value >> 1) ^ reflected_polynomial;
+			}
+			else
+			{
+				crc_value >>= 1;
+			}
+		}
+		crc32_nibble_table_reflected[nibble_value] = crc_value;
+	}
+}
+
+
+// same as update_crc32_table(), but with two lookups per byte in a 16 entry table instead of one in a 256 entry table:
+// the register is advanced 4 bits at a time. the table has to match the register direction, i.e. crc32_nibble_table or
+// crc32_nibble_table_reflected as built by generate_crc32_nibble_table(), or a registry nibble table.
+uint32_t update_crc32_nibble(	const uint32_t* table,
+							uint32_t calculated_crc,
+							const uint8_t* byte_data,
+							size_t data_len,
+							uint8_t reflected )
+{
+	size_t byte_data_index;
+
+	if(reflected == 1)
+	{
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+		{
+			// xor in the next input byte, **at the LSB**
+			calculated_crc ^= byte_data[byte_data_index];
+
+			// the low nibble leaves the register first: it's the index, shift it out and xor in what it leaves behind. twice per byte.
+			calculated_crc = (calculated_crc >> 4) ^ table[calculated_crc & 0x0F];
+			calculated_crc = (calculated_crc >> 4) ^ table[calculated_crc & 0x0F];
+		}
+
+		return calculated_crc;
+	}
+
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	{
+		// xor in the next input byte, **at the MSB**
+		calculated_crc ^= (uint32_t)byte_data[byte_data_index] << (CRC_WIDTH_32-8);
+
+		// the top nibble is the index this time, high nibble first.
+		calculated_crc = (calculated_crc << 4) ^ table[calculated_crc >> (CRC_WIDTH_32-4)];
+		calculated_crc = (calculated_crc << 4) ^ table[calculated_crc >> (CRC_WIDTH_32-4)];
+	}
+
+	return calculated_crc;
+}
+#endif // #ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+
+
+uint32_t calculate_crc32(	uint8_t* byte_data,
+						int32_t data_len,
+						uint32_t crc_config_initial_value,
+						uint32_t crc_config_final_xor_value,
+						uint32_t crc_config_polynomial,
+						uint8_t crc_config_reflect_input,
+						uint8_t crc_config_reflect_output )
+{
+	// refin=true models are run natively on a reflected (LSB-first) register, instead of reflecting every input byte
+	// and then the whole crc again at the end. the register, the polynomial and the table are all bit-reversed,
+	// so the input byte goes in at the LSB untouched and the register shifts right.
+	uint8_t reflected = (crc_config_reflect_input == 1);
+	size_t remaining_len = (data_len > 0) ? (size_t)data_len : 0;
+	uint32_t calculated_crc = reflected ? (uint32_t)reflect(crc_config_initial_value,CRC_WIDTH_32) : crc_config_initial_value;
+
+#ifdef USE_HW_FOR_CRC_32C
+	// CRC-32C runs on the same reflected register in hardware, only the loop is swapped out.
+	if(reflected == 1 && crc_config_polynomial == CRC_32C_POLYNOMIAL && crc32c_hw_available())
+	{
+		calculated_crc = update_crc32c_hw(calculated_crc,byte_data,remaining_len);
+		remaining_len = 0;
+	}
+#endif // USE_HW_FOR_CRC_32C
+
+#ifdef USE_CLMUL_FOR_CRC_32
+	// fold the bulk with PCLMULQDQ, the table below finishes the last (data_len % 16) bytes.
+	if(remaining_len >= CRC_CLMUL_MIN_LEN && crc_clmul_available())
+	{
+		calculated_crc = (uint32_t)update_crc_clmul(reflected ? &crc32_clmul_constants_reflected : &crc32_clmul_constants,calculated_crc,byte_data,remaining_len & ~(size_t)15);
+		byte_data += remaining_len & ~(size_t)15;
+		remaining_len &= 15;
+	}
+#endif // USE_CLMUL_FOR_CRC_32
+
+#ifdef USE_TABLE_FOR_CRC_32
+	calculated_crc = update_crc32_table(reflected ? crc32_table_reflected : crc32_table,calculated_crc,byte_data,remaining_len,reflected);
+#elif defined(USE_NIBBLE_TABLE_FOR_CRC_32)
+	calculated_crc = update_crc32_nibble(reflected ? crc32_nibble_table_reflected : crc32_nibble_table,calculated_crc,byte_data,remaining_len,reflected);
+#else
+	calculated_crc = update_crc32_bitwise(crc_config_polynomial,calculated_crc,byte_data,remaining_len,reflected);
+#endif // USE_TABLE_FOR_CRC_32
+
+	// the register is in the input direction, it only needs reflecting if the output direction is different.
+	if(reflected != (crc_config_reflect_output == 1))
+	{
+		calculated_crc = (reflect(calculated_crc,CRC_WIDTH_32) & CRC_MASK(CRC_WIDTH_32));
+	}
+
+	// xor with final_xor_value:
+	calculated_crc ^= crc_config_final_xor_value;
+
+//	printf("calculated_crc_32 = 0x%04X\n",calculated_crc);
+
+	return calculated_crc;
+}
+
+
+#ifdef USE_SLICING_FOR_CRC_32
+void generate_crc32_slicing_tables(uint32_t generator_polynomial)
+{
+	uint16_t byte_value;
+	uint8_t slice_index;
+
+	// slice 0 is the plain byte table, for both directions.
+	generate_crc32_table(generator_polynomial);
+
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		crc32_slicing_table[0][byte_value] = crc32_table[byte_value];
+		crc32_slicing_table_reflected[0][byte_value] = crc32_table_reflected[byte_value];
+	}
+
+	// every next slice pushes one more zero byte through the register: one more byte table step on the previous slice.
+	for (slice_index = 1; slice_index < CRC_SLICES_MAX; slice_index++)
+	{
+		for (byte_value = 0; byte_value < 256; byte_value++)
+		{
+			uint32_t crc_value = crc32_slicing_table[slice_index-1][byte_value];
+			crc32_slicing_table[slice_index][byte_value] = (crc_value << 8) ^ crc32_table[crc_value >> (CRC_WIDTH_32-8)];
+
+			crc_value = crc32_slicing_table_reflected[slice_index-1][byte_value];
+			crc32_slicing_table_reflected[slice_index][byte_value] = (crc_value >> 8) ^ crc32_table_reflected[crc_value & 0xFF];
+		}
+	}
+}
+
+
+// runs the raw (reflected, LSB-first) register over the data, 'slices' bytes per iteration.
+// the first 4 bytes of each block are xored into the register, the rest are looked up as-is;
+// byte i of the block goes through table[slices-1-i], i.e. the table that accounts for the bytes still following it.
+static inline uint32_t update_crc32_slicing_reflected(const uint32_t (*slicing_table)[256], uint32_t calculated_crc, const uint8_t* byte_data, size_t data_len, const uint8_t slices)
+{
+	uint8_t byte_index;
+	uint32_t next_crc;
+
+	while (slices >= CRC_SLICES_4 && data_len >= slices)
+	{
+		calculated_crc ^= (uint32_t)byte_data[0] | ((uint32_t)byte_data[1] << 8) | ((uint32_t)byte_data[2] << 16) | ((uint32_t)byte_data[3] << 24);
+
+		next_crc =	slicing_table[slices-1][calculated_crc & 0xFF] ^
+					slicing_table[slices-2][(calculated_crc >> 8) & 0xFF] ^
+					slicing_table[slices-3][(calculated_crc >> 16) & 0xFF] ^
+					slicing_table[slices-4][calculated_crc >> 24];
+
+#if defined(__GNUC__)
+#pragma GCC unroll 16
+#endif // __GNUC__
+		for (byte_index = 4; byte_index < slices; byte_index++)
+		{
+			next_crc ^= slicing_table[slices-1-byte_index][byte_data[byte_index]];
+		}
+
+		calculated_crc = next_crc;
+		byte_data += slices;
+		data_len -= slices;
+	}
+
+	// tail, byte by byte.
+	while (data_len-- > 0)
+	{
+		calculated_crc = (calculated_crc >> 8) ^ slicing_table[0][(calculated_crc ^ *byte_data++) & 0xFF];
+	}
+
+	return calculated_crc;
+}
+
+
+// same thing for the normal (MSB-first) register, the block is read big-endian so its first byte lines up with the MSB.
+static inline uint32_t update_crc32_slicing(const uint32_t (*slicing_table)[256], uint32_t calculated_crc, const uint8_t* byte_data, size_t data_len, const uint8_t slices)
+{
+	uint8_t byte_index;
+	uint32_t next_crc;
+
+	while (slices >= CRC_SLICES_4 && data_len >= slices)
+	{
+		calculated_crc ^= ((uint32_t)byte_data[0] << 24) | ((uint32_t)byte_data[1] << 16) | ((uint32_t)byte_data[2] << 8) | (uint32_t)byte_data[3];
+
+		next_crc =	slicing_table[slices-1][calculated_crc >> 24] ^
+					slicing_table[slices-2][(calculated_crc >> 16) & 0xFF] ^
+					slicing_table[slices-3][(calculated_crc >> 8) & 0xFF] ^
+					slicing_table[slices-4][calculated_crc & 0xFF];
+
+#if defined(__GNUC__)
+#pragma GCC unroll 16
+#endif // __GNUC__
+		for (byte_index = 4; byte_index < slices; byte_index++)
+		{
+			next_crc ^= slicing_table[slices-1-byte_index][byte_data[byte_index]];
+		}
+
+		calculated_crc = next_crc;
+		byte_data += slices;
+		data_len -= slices;
+	}
+
+	// tail, byte by byte.
+	while (data_len-- > 0)
+	{
+		calculated_crc = (calculated_crc << 8) ^ slicing_table[0][(calculated_crc >> (CRC_WIDTH_32-8)) ^ *byte_data++];
+	}
+
+	return calculated_crc;
+}
+
+
+// runs the raw register (in the given direction) over the data with slicing-by-N, slices is one of CRC_SLICES_4/8/16,
+// anything else runs the byte table (slice 0). the slicing tables have to match the direction.
+uint32_t update_crc32_sliced(	const uint32_t (*slicing_table)[256],
+							uint32_t calculated_crc,
+							const uint8_t* byte_data,
+							size_t data_len,
+							uint8_t slices,
+							uint8_t reflected )
+{
+	// the slice count is passed as a constant so each case gets its own fully unrolled loop.
+	if(reflected == 1)
+	{
+		switch(slices)
+		{
+			case CRC_SLICES_16:	return update_crc32_slicing_reflected(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_16);
+			case CRC_SLICES_8:	return update_crc32_slicing_reflected(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_8);
+			case CRC_SLICES_4:	return update_crc32_slicing_reflected(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_4);
+			default:			return update_crc32_slicing_reflected(slicing_table,calculated_crc,byte_data,data_len,1);
+		}
+	}
+
+	switch(slices)
+	{
+		case CRC_SLICES_16:	return update_crc32_slicing(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_16);
+		case CRC_SLICES_8:	return update_crc32_slicing(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_8);
+		case CRC_SLICES_4:	return update_crc32_slicing(slicing_table,calculated_crc,byte_data,data_len,CRC_SLICES_4);
+		default:			return update_crc32_slicing(slicing_table,calculated_crc,byte_data,data_len,1);
+	}
+}
+
+
+// slicing-by-N version of calculate_crc32(), crc_config_slices is one of CRC_SLICES_4/8/16 (anything else runs
+// the byte table). needs generate_crc32_slicing_tables() for the polynomial first, just like the plain table version.
+uint32_t calculate_crc32_slicing(	uint8_t* byte_data,
+									int32_t data_len,
+									uint32_t crc_config_initial_value,
+									uint32_t crc_config_final_xor_value,
+									uint32_t crc_config_polynomial,
+									uint8_t crc_config_reflect_input,
+									uint8_t crc_config_reflect_output,
+									uint8_t crc_config_slices )
+{
+	uint8_t reflected = (crc_config_reflect_input == 1);
+	uint32_t calculated_crc = reflected ? (uint32_t)reflect(crc_config_initial_value,CRC_WIDTH_32) : crc_config_initial_value;
+
+	(void)crc_config_polynomial; // baked into the tables.
+
+	calculated_crc = update_crc32_sliced(	reflected ? crc32_slicing_table_reflected : crc32_slicing_table,
+											calculated_crc,byte_data,(data_len > 0) ? (size_t)data_len : 0,crc_config_slices,reflected);
+
+	if(reflected != (crc_config_reflect_output == 1))
+	{
+		calculated_crc = (reflect(calculated_crc,CRC_WIDTH_32) & CRC_MASK(CRC_WIDTH_32));
+	}
+
+	return calculated_crc ^ crc_config_final_xor_value;
+}
+
+
+// cross-check of the slicing engines against calculate_crc32() (byte table), over a buffer long enough to
+// run the sliced loop several times, for every slice count, at odd lengths and unaligned start offsets.
+int check_crc32_slicing_engine(uint32_t crc_config_initial_value,
+								uint32_t crc_config_final_xor_value,
+								uint32_t crc_config_polynomial,
+								uint8_t crc_config_reflect_input,
+								uint8_t crc_config_reflect_output )
+{
+	static const uint8_t slice_counts [3] = {CRC_SLICES_4, CRC_SLICES_8, CRC_SLICES_16};
+	uint8_t data_array [1031];
+	int32_t data_len, data_offset;
+	uint8_t slice_index;
+	uint32_t expected_crc;
+
+	fill_crc_test_data(data_array, sizeof(data_array), 0x85EBCA6B);
+
+	generate_crc32_slicing_tables(crc_config_polynomial);
+
+	for (data_offset = 0; data_offset < 4; data_offset++)
+	{
+		for (data_len = 0; data_len < (int32_t)sizeof(data_array) - data_offset; data_len += 37)
+		{
+			expected_crc = calculate_crc32(data_array + data_offset,data_len,crc_config_initial_value,crc_config_final_xor_value,crc_config_polynomial,crc_config_reflect_input,crc_config_reflect_output);
+
+			for (slice_index = 0; slice_index < sizeof(slice_counts); slice_index++)
+			{
+				if( expected_crc != calculate_crc32_slicing(data_array + data_offset,data_len,crc_config_initial_value,crc_config_final_xor_value,crc_config_polynomial,crc_config_reflect_input,crc_config_reflect_output,slice_counts[slice_index]) )
+				{
+					printf("slicing-by-%d mismatch, poly 0x%08X, len %d, offset %d\n",slice_counts[slice_index],crc_config_polynomial,data_len,data_offset);
+					return -1;
+				}
+			}
+		}
+	}
+
+	return 1; // ok.
+}
+#endif // #ifdef USE_SLICING_FOR_CRC_32
+
+
+#ifdef USE_HW_FOR_CRC_32C
+// cross-check of the hardware crc32c engines (single stream and 3-way) against the bitwise reflected loop,
+// with lengths around the short and long block sizes and every start offset within a 64-bit word.
+int check_crc32c_hw_engine()
+{
+	static uint8_t data_array [3*CRC_32C_HW_LONG_BLOCK + 3*CRC_32C_HW_SHORT_BLOCK + 100];
+	static const int32_t data_lengths [] = {0, 1, 7, 8, 9, 63, 3*CRC_32C_HW_SHORT_BLOCK - 1, 3*CRC_32C_HW_SHORT_BLOCK, 3*CRC_32C_HW_SHORT_BLOCK + 13,
+											3*CRC_32C_HW_LONG_BLOCK - 1, 3*CRC_32C_HW_LONG_BLOCK, 3*CRC_32C_HW_LONG_BLOCK + 3*CRC_32C_HW_SHORT_BLOCK + 91};
+	uint32_t reflected_polynomial = reflect(CRC_32C_POLYNOMIAL,CRC_WIDTH_32);
+	uint32_t expected_crc;
+	int32_t data_index, length_index, data_offset;
+	uint8_t bit_index;
+
+	if (!crc32c_hw_available())
+	{
+		return 1; // nothing to check, calculate_crc32() stays on the table.
+	}
+
+	fill_crc_test_data(data_array, sizeof(data_array), 0x9E3779B9);
+
+	for (length_index = 0; length_index < (int32_t)(sizeof(data_lengths)/sizeof(data_lengths[0])); length_index++)
+	{
+		for (data_offset = 0; data_offset < 8; data_offset++)
+		{
+			expected_crc = 0xFFFFFFFF;
+			for (data_index = 0; data_index < data_lengths[length_index]; data_index++)
+			{
+				expected_crc ^= data_array[data_offset + data_index];
+				for (bit_index = 0; bit_index < 8; bit_index++)
+				{
+					expected_crc = (expected_crc & 1) ? (expected_crc >> 1) ^ reflected_polynomial : (expected_crc >> 1);
+				}
+			}
+
+			if( expected_crc != update_crc32c_hw_single(0xFFFFFFFF,data_array + data_offset,(size_t)data_lengths[length_index]) ||
+				(__builtin_cpu_supports("pclmul") && expected_crc != update_crc32c_hw_3way(0xFFFFFFFF,data_array + data_offset,(size_t)data_lengths[length_index])) )
+			{
+				printf("crc32c hardware mismatch, len %d, offset %d\n",data_lengths[length_index],data_offset);
+				return -1;
+			}
+		}
+	}
+
+	return 1; // ok.
+}
+#endif // #ifdef USE_HW_FOR_CRC_32C
+
+
+int check_crc_32_algo()
+{
+	// simple 1
+	// CRC-32/BZIP2 : width=32 poly=0x04c11db7 init=0xffffffff refin=false refout=false xorout=0xffffffff check=0xfc891918 name="CRC-32/BZIP2"
+#ifdef USE_TABLE_FOR_CRC_32
+	generate_crc32_table(0x04C11DB7); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+	generate_crc32_nibble_table(0x04C11DB7);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_32
+	if( 0xFC891918 != calculate_crc32((uint8_t*)"123456789",9,0xFFFFFFFF,0xFFFFFFFF,0x04C11DB7,0,0) )
+	{
+		printf ("CRC-32/BZIP2 reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-32/BZIP2 check passed.\n\n");
+	}
+
+
+
+	// reflect input data and output crc
+	// CRC-32 : width=32 poly=0x04c11db7 init=0xffffffff refin=true refout=true xorout=0xffffffff check=0xcbf43926 name="CRC-32"
+#ifdef USE_TABLE_FOR_CRC_32
+	generate_crc32_table(0x04C11DB7); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+	generate_crc32_nibble_table(0x04C11DB7);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_32
+	if( 0xCBF43926 != calculate_crc32((uint8_t*)"123456789",9,0xFFFFFFFF,0xFFFFFFFF,0x04C11DB7,1,1) )
+	{
+		printf ("CRC-32 reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-32 check passed.\n\n");
+	}
+
+
+
+	// reflect input data and output crc - 2
+	// CRC-32C : width=32 poly=0x1edc6f41 init=0xffffffff refin=true refout=true xorout=0xffffffff check=0xe3069283 name="CRC-32C"
+#ifdef USE_TABLE_FOR_CRC_32
+	generate_crc32_table(0x1EDC6f41); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+	generate_crc32_nibble_table(0x1EDC6f41);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_32
+	if( 0xE3069283 != calculate_crc32((uint8_t*)"123456789",9,0xFFFFFFFF,0xFFFFFFFF,0x1EDC6f41,1,1) )
+	{
+		printf ("CRC-32C reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-32C check passed.\n\n");
+	}
+
+
+	// reflect input data and output crc, no xor-out
+	// CRC-32/JAMCRC : width=32 poly=0x04c11db7 init=0xffffffff refin=true refout=true xorout=0x00000000 check=0x340bc6d9 name="JAMCRC"
+#ifdef USE_TABLE_FOR_CRC_32
+	generate_crc32_table(0x04C11DB7); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_32
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+	generate_crc32_nibble_table(0x04C11DB7);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_32
+	if( 0x340BC6D9 != calculate_crc32((uint8_t*)"123456789",9,0xFFFFFFFF,0x00000000,0x04C11DB7,1,1) )
+	{
+		printf ("CRC-32/JAMCRC reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-32/JAMCRC check passed.\n\n");
+	}
+
+	// no reflection, no xor-out
+	// CRC-32/MPEG-2 : width=32 poly=0x04c11db7 init=0xffffffff refin=false refout=false xorout=0x00000000 check=0x0376e6e7 name="CRC-32/MPEG-2"
+#ifdef USE_TABLE_FOR_CRC_32
+	generate_crc32_table(0x04C11DB7); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_32
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+	generate_crc32_nibble_table(0x04C11DB7);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_32
+	if( 0x0376E6E7 != calculate_crc32((uint8_t*)"123456789",9,0xFFFFFFFF,0x00000000,0x04C11DB7,0,0) )
+	{
+		printf ("CRC-32/MPEG-2 reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-32/MPEG-2 check passed.\n\n");
+	}
+
+	// no reflection, zero init value
+	// CRC-32/POSIX : width=32 poly=0x04c11db7 init=0x00000000 refin=false refout=false xorout=0xffffffff check=0x765e7680 name="CRC-32/POSIX"
+#ifdef USE_TABLE_FOR_CRC_32
+	generate_crc32_table(0x04C11DB7); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_32
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+	generate_crc32_nibble_table(0x04C11DB7);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_32
+	if( 0x765E7680 != calculate_crc32((uint8_t*)"123456789",9,0x00000000,0xFFFFFFFF,0x04C11DB7,0,0) )
+	{
+		printf ("CRC-32/POSIX reference check failed!\n\n");
+		return -1;
+	}
+	else
+	{
+//		printf ("CRC-32/POSIX check passed.\n\n");
+	}
+
+
+
+#ifdef USE_SLICING_FOR_CRC_32
+	// slicing-by-4/8/16 against the byte table, both register directions.
+	if( check_crc32_slicing_engine(0xFFFFFFFF,0xFFFFFFFF,0x04C11DB7,1,1) != 1 )
+	{
+		printf ("CRC-32 slicing check failed!\n\n");
+		return -1;
+	}
+	if( check_crc32_slicing_engine(0xFFFFFFFF,0xFFFFFFFF,0x04C11DB7,0,0) != 1 )
+	{
+		printf ("CRC-32/BZIP2 slicing check failed!\n\n");
+		return -1;
+	}
+	if( check_crc32_slicing_engine(0xFFFFFFFF,0xFFFFFFFF,0x1EDC6F41,1,1) != 1 )
+	{
+		printf ("CRC-32C slicing check failed!\n\n");
+		return -1;
+	}
+#endif // USE_SLICING_FOR_CRC_32
+
+
+#ifdef USE_HW_FOR_CRC_32C
+	// SSE4.2 crc32 instruction engine, single stream and 3-way, against the bitwise loop.
+	if( check_crc32c_hw_engine() != 1 )
+	{
+		printf ("CRC-32C hardware check failed!\n\n");
+		return -1;
+	}
+#endif // USE_HW_FOR_CRC_32C
+
+
+	return 1; // ok.
+}
+///////////////////////////////////////////////////////////////////		CRC32 FUNCTIONS --	///////////////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////		CRC64 FUNCTIONS ++	///////////////////////////////////////////////////////////////////
+#ifdef USE_TABLE_FOR_CRC_64
+void generate_crc64_table(uint64_t generator_polynomial)
+{
+	uint16_t byte_value;
+	uint8_t bit_index;
+	uint64_t crc_value;
+	uint64_t reflected_polynomial = reflect(generator_polynomial,CRC_WIDTH_64);
+
+	// iterate over all byte values 0 - 255
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		crc_value = (uint64_t)byte_value << (CRC_WIDTH_64 - 8); // move byte into MSB of 64Bit CRC
+
+		for (bit_index = 0; bit_index < 8; bit_index++)
+		{
+			if ((crc_value & TOPBIT(CRC_WIDTH_64)) != 0)
+			{
+				crc_value = (crc_value << 1) ^ generator_polynomial;
+			}
+			else
+			{
+				crc_value <<= 1;
+			}
+		}
+		crc64_table[byte_value] = crc_value;
+
+		// reflected (LSB-first) register, for refin=true models.
+		crc_value = byte_value;
+
+		for (bit_index = 0; bit_index < 8; bit_index++)
+		{
+			if ((crc_value & 1) != 0)
+			{
+				crc_value = (crc_value >> 1) ^ reflected_polynomial;
+			}
+			else
+			{
+				crc_value >>= 1;
+			}
+		}
+		crc64_table_reflected[byte_value] = crc_value;
+	}
+
+#ifdef USE_CLMUL_FOR_CRC_64
+	generate_crc_clmul64_constants(&crc64_clmul_constants, generator_polynomial, 0);
+	generate_crc_clmul64_constants(&crc64_clmul_constants_reflected, generator_polynomial, 1);
+#endif // USE_CLMUL_FOR_CRC_64
+}
+#endif // #ifdef USE_TABLE_FOR_CRC_64
+
+
+#ifdef USE_TABLE_FOR_CRC_64
+void print_crc64_table()
+{
+	uint16_t byte_value;
+
+	printf("crc64_table == \n{\n");
+
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		printf("%016llX,\n",(unsigned long long)crc64_table[byte_value]);
+	}
+
+	printf("};\n\n");
+
+	printf("crc64_table_reflected == \n{\n");
+
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		printf("%016llX,\n",(unsigned long long)crc64_table_reflected[byte_value]);
+	}
+
+	printf("};\n\n");
+}
+#endif // #ifdef USE_TABLE_FOR_CRC_64
+
+
+// same as update_crc32_bitwise(), 64 bit register.
+uint64_t update_crc64_bitwise(	uint64_t crc_config_polynomial,
+								uint64_t calculated_crc,
+								const uint8_t* byte_data,
+								size_t data_len,
+								uint8_t reflected )
+{
+	size_t byte_data_index;
+	uint8_t bit_index;
+	uint64_t reflected_polynomial = reflect(crc_config_polynomial,CRC_WIDTH_64);
+
+	if(reflected == 1)
+	{
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+		{
+			// xor in the next input byte, **at the LSB**
+			calculated_crc ^= byte_data[byte_data_index];
+
+			for (bit_index = 0; bit_index < 8; bit_index++)
+			{
+				if ((calculated_crc & 1) != 0)
+				{
+					calculated_crc = (calculated_crc >> 1) ^ reflected_polynomial;
+				}
+				else
+				{
+					calculated_crc >>= 1;
+				}
+			}
+		}
+
+		return calculated_crc;
+	}
+
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	{
+		// xor in the next input byte, **at the MSB**
+		calculated_crc ^= (uint64_t)byte_data[byte_data_index] << (CRC_WIDTH_64-8);
+
+		for (bit_index = 0; bit_index < 8; bit_index++)
+		{
+			if ((calculated_crc & TOPBIT(CRC_WIDTH_64)) != 0)
+			{
+				calculated_crc = (calculated_crc << 1) ^ crc_config_polynomial;
+			}
+			else
+			{
+				calculated_crc <<= 1;
+			}
+		}
+	}
+
+	return calculated_crc;
+}
+
+
+#ifdef USE_TABLE_FOR_CRC_64
+// same as update_crc32_table(), 64 bit register.
+uint64_t update_crc64_table(	const uint64_t* table,
+							uint64_t calculated_crc,
+							const uint8_t* byte_data,
+							size_t data_len,
+							uint8_t reflected )
+{
+	size_t byte_data_index;
+
+	if(reflected == 1)
+	{
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+		{
+			calculated_crc = (calculated_crc >> 8) ^ (table[(calculated_crc ^ byte_data[byte_data_index]) & 0xFF]);
+		}
+
+		return calculated_crc;
+	}
+
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	{
+		calculated_crc = (calculated_crc << 8) ^ (table[(calculated_crc >> (CRC_WIDTH_64-8)) ^ byte_data[byte_data_index]]);
+	}
+
+	return calculated_crc;
+}
+#endif // #ifdef USE_TABLE_FOR_CRC_64
+
+
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_64
+// 16 entry tables for update_crc64_nibble(): the register after 4 shift steps, starting from each nibble value at the
+// end of the register the data goes in at. both directions, like generate_crc64_table().
+void generate_crc64_nibble_table(uint64_t generator_polynomial)
+{
+	uint8_t nibble_value;
+	uint8_t bit_index;
+	uint64_t crc_value;
+	uint64_t reflected_polynomial = (uint64_t)reflect(generator_polynomial,CRC_WIDTH_64);
+
+	// iterate over all nibble values 0 - 15
+	for (nibble_value = 0; nibble_value < 16; nibble_value++)
+	{
+		crc_value = (uint64_t)nibble_value << (CRC_WIDTH_64 - 4); // move nibble into the top 4 bits of the register
+
+		for (bit_index = 0; bit_index < 4; bit_index++)
+		{
+			if ((crc_value & TOPBIT(CRC_WIDTH_64)) != 0)
+			{
+				crc_value = (crc_value << 1) ^ generator_polynomial;
+			}
+			else
+			{
+				crc_value <<= 1;
+			}
+		}
+		crc64_nibble_table[nibble_value] = crc_value;
+
+		// reflected (LSB-first) register: the nibble goes into the low 4 bits, the register shifts right.
+		crc_value = nibble_value;
+
+		for (bit_index = 0; bit_index < 4; bit_index++)
+		{
+			if ((crc_value & 1) != 0)
+			{
+				crc_value = (crc_value >> 1) ^ reflected_polynomial;
+			}
+			else
+			{
+				crc_value >>= 1;
+			}
+		}
+		crc64_nibble_table_reflected[nibble_value] = crc_value;
+	}
+}
+
+
+// same as update_crc32_nibble(), 64 bit register.
+uint64_t update_crc64_nibble(	const uint64_t* table,
+							uint64_t calculated_crc,
+							const uint8_t* byte_data,
+							size_t data_len,
+							uint8_t reflected )
+{
+	size_t byte_data_index;
+
+	if(reflected == 1)
+	{
+		for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+		{
+			calculated_crc ^= byte_data[byte_data_index];
+			calculated_crc = (calculated_crc >> 4) ^ table[calculated_crc & 0x0F];
+			calculated_crc = (calculated_crc >> 4) ^ table[calculated_crc & 0x0F];
+		}
+
+		return calculated_crc;
+	}
+
+	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	{
+		calculated_crc ^= (uint64_t)byte_data[byte_data_index] << (CRC_WIDTH_64-8);
+		calculated_crc = (calculated_crc << 4) ^ table[calculated_crc >> (CRC_WIDTH_64-4)];
+		calculated_crc = (calculated_crc << 4) ^ table[calculated_crc >> (CRC_WIDTH_64-4)];
+	}
+
+	return calculated_crc;
+}
+#endif // #ifdef USE_NIBBLE_TABLE_FOR_CRC_64
+
+
+uint64_t calculate_crc64(	uint8_t* byte_data,
+						int32_t data_len,
+						uint64_t crc_config_initial_value,
+						uint64_t crc_config_final_xor_value,
+						uint64_t crc_config_polynomial,
+						uint8_t crc_config_reflect_input,
+						uint8_t crc_config_reflect_output )
+{
+	// same register handling as calculate_crc32().
+	uint8_t reflected = (crc_config_reflect_input == 1);
+	size_t remaining_len = (data_len > 0) ? (size_t)data_len : 0;
+	uint64_t calculated_crc = reflected ? reflect(crc_config_initial_value,CRC_WIDTH_64) : crc_config_initial_value;
+
+#ifdef USE_CLMUL_FOR_CRC_64
+	// fold the bulk with PCLMULQDQ, the table below finishes the last (data_len % 16) bytes.
+	if(remaining_len >= CRC_CLMUL_MIN_LEN && crc_clmul_available())
+	{
+		calculated_crc = update_crc_clmul64(reflected ? &crc64_clmul_constants_reflected : &crc64_clmul_constants,calculated_crc,byte_data,remaining_len & ~(size_t)15);
+		byte_data += remaining_len & ~(size_t)15;
+		remaining_len &= 15;
+	}
+#endif // USE_CLMUL_FOR_CRC_64
+
+#ifdef USE_TABLE_FOR_CRC_64
+	(void)crc_config_polynomial; // baked into the tables.
+	calculated_crc = update_crc64_table(reflected ? crc64_table_reflected : crc64_table,calculated_crc,byte_data,remaining_len,reflected);
+#elif defined(USE_NIBBLE_TABLE_FOR_CRC_64)
+	(void)crc_config_polynomial; // baked into the tables.
+	calculated_crc = update_crc64_nibble(reflected ? crc64_nibble_table_reflected : crc64_nibble_table,calculated_crc,byte_data,remaining_len,reflected);
+#else
+	calculated_crc = update_crc64_bitwise(crc_config_polynomial,calculated_crc,byte_data,remaining_len,reflected);
+#endif // USE_TABLE_FOR_CRC_64
+
+	if(reflected != (crc_config_reflect_output == 1))
+	{
+		calculated_crc = reflect(calculated_crc,CRC_WIDTH_64);
+	}
+
+	return calculated_crc ^ crc_config_final_xor_value;
+}
+
+
+#ifdef USE_SLICING_FOR_CRC_64
+void generate_crc64_slicing_tables(uint64_t generator_polynomial)
+{
+	uint16_t byte_value;
+	uint8_t slice_index;
+	uint64_t crc_value;
+
+	generate_crc64_table(generator_polynomial);
+
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		crc64_slicing_table[0][byte_value] = crc64_table[byte_value];
+		crc64_slicing_table_reflected[0][byte_value] = crc64_table_reflected[byte_value];
+	}
+
+	for (slice_index = 1; slice_index < CRC_SLICES_8; slice_index++)
+	{
+		for (byte_value = 0; byte_value < 256; byte_value++)
+		{
+			crc_value = crc64_slicing_table[slice_index-1][byte_value];
+			crc64_slicing_table[slice_index][byte_value] = (crc_value << 8) ^ crc64_table[crc_value >> (CRC_WIDTH_64-8)];
+
+			crc_value = crc64_slicing_table_reflected[slice_index-1][byte_value];
+			crc64_slicing_table_reflected[slice_index][byte_value] = (crc_value >> 8) ^ crc64_table_reflected[crc_value & 0xFF];
+		}
+	}
+}
+
+
+// slicing-by-8 on the reflected register: a block is exactly as wide as the register, so all 8 bytes are xored in
+// and every byte of the result is looked up, nothing of the old register is carried over.
+static inline uint64_t update_crc64_slicing_reflected(const uint64_t (*slicing_table)[256], uint64_t calculated_crc, const uint8_t* byte_data, size_t data_len)
+{
+	while (data_len >= CRC_SLICES_8)
+	{
+		calculated_crc ^=	(uint64_t)byte_data[0] | ((uint64_t)byte_data[1] << 8) | ((uint64_t)byte_data[2] << 16) | ((uint64_t)byte_data[3] << 24) |
+							((uint64_t)byte_data[4] << 32) | ((uint64_t)byte_data[5] << 40) | ((uint64_t)byte_data[6] << 48) | ((uint64_t)byte_data[7] << 56);
+
+		calculated_crc =	slicing_table[7][calculated_crc & 0xFF] ^
+							slicing_table[6][(calculated_crc >> 8) & 0xFF] ^
+							slicing_table[5][(calculated_crc >> 16) & 0xFF] ^
+							slicing_table[4][(calculated_crc >> 24) & 0xFF] ^
+							slicing_table[3][(calculated_crc >> 32) & 0xFF] ^
+							slicing_table[2][(calculated_crc >> 40) & 0xFF] ^
+							slicing_table[1][(calculated_crc >> 48) & 0xFF] ^
+							slicing_table[0][calculated_crc >> 56];
+
+		byte_data += CRC_SLICES_8;
+		data_len -= CRC_SLICES_8;
+	}
+
+	// tail, byte by byte.
+	while (data_len-- > 0)
+	{
+		calculated_crc = (calculated_crc >> 8) ^ slicing_table[0][(calculated_crc ^ *byte_data++) & 0xFF];
+	}
+
+	return calculated_crc;
+}
+
+
+// same for the normal register, the block is read big-endian.
+static inline uint64_t update_crc64_slicing(const uint64_t (*slicing_table)[256], uint64_t calculated_crc, const uint8_t* byte_data, size_t data_len)
+{
+	while (data_len >= CRC_SLICES_8)
+	{
+		calculated_crc ^=	((uint64_t)byte_data[0] << 56) | ((uint64_t)byte_data[1] << 48) | ((uint64_t)byte_data[2] << 40) | ((uint64_t)byte_data[3] << 32) |
+							((uint64_t)byte_data[4] << 24) | ((uint64_t)byte_data[5] << 16) | ((uint64_t)byte_data[6] << 8) | (uint64_t)byte_data[7];
+
+		calculated_crc =	slicing_table[7][calculated_crc >> 56] ^
+							slicing_table[6][(calculated_crc >> 48) & 0xFF] ^
+							slicing_table[5][(calculated_crc >> 40) & 0xFF] ^
+							slicing_table[4][(calculated_crc >> 32) & 0xFF] ^
+							slicing_table[3][(calculated_crc >> 24) & 0xFF] ^
+							slicing_table[2][(calculated_crc >> 16) & 0xFF] ^
+							slicing_table[1][(calculated_crc >> 8) & 0xFF] ^
+							slicing_table[0][calculated_crc & 0xFF];
+
+		byte_data += CRC_SLICES_8;
+		data_len -= CRC_SLICES_8;
+	}
+
+	// tail, byte by byte.
+	while (data_len-- > 0)
+	{
+		calculated_crc = (calculated_crc << 8) ^ slicing_table[0][(calculated_crc >> (CRC_WIDTH_64-8)) ^ *byte_data++];
+	}
+
+	return calculated_crc;
+}
+
+
+// runs the raw register (in the given direction) over the data, slicing-by-8 if slices is CRC_SLICES_8, else the byte table.
+uint64_t update_crc64_sliced(	const uint64_t (*slicing_table)[256],
+							uint64_t calculated_crc,
+							const uint8_t* byte_data,
+							size_t data_len,
+							uint8_t slices,
+							uint8_t reflected )
+{
+	if (slices != CRC_SLICES_8)
+	{
+		return update_crc64_table(slicing_table[0],calculated_crc,byte_data,data_len,reflected);
+	}
+
+	if(reflected == 1)
+	{
+		return update_crc64_slicing_reflected(slicing_table,calculated_crc,byte_data,data_len);
+	}
+
+	return update_crc64_slicing(slicing_table,calculated_crc,byte_data,data_len);
+}
+
+
+// slicing-by-8 version of calculate_crc64(), needs generate_crc64_slicing_tables() for the polynomial first.
+uint64_t calculate_crc64_slicing(	uint8_t* byte_data,
+									int32_t data_len,
+									uint64_t crc_config_initial_value,
+									uint64_t crc_config_final_xor_value,
+									uint64_t crc_config_polynomial,
+									uint8_t crc_config_reflect_input,
+									uint8_t crc_config_reflect_output )
+{
+	uint8_t reflected = (crc_config_reflect_input == 1);
+	uint64_t calculated_crc = reflected ? reflect(crc_config_initial_value,CRC_WIDTH_64) : crc_config_initial_value;
+
+	(void)crc_config_polynomial; // baked into the tables.
+
+	calculated_crc = update_crc64_sliced(	reflected ? crc64_slicing_table_reflected : crc64_slicing_table,
+											calculated_crc,byte_data,(data_len > 0) ? (size_t)data_len : 0,CRC_SLICES_8,reflected);
+
+	if(reflected != (crc_config_reflect_output == 1))
+	{
+		calculated_crc = reflect(calculated_crc,CRC_WIDTH_64);
+	}
+
+	return calculated_crc ^ crc_config_final_xor_value;
+}
+
+
+// cross-check of slicing-by-8 and of calculate_crc64() (PCLMULQDQ folding over 64 bytes, table below) against the bitwise loop,
+// at odd lengths and unaligned start offsets.
+int check_crc64_slicing_engine(uint64_t crc_config_initial_value,
+								uint64_t crc_config_final_xor_value,
+								uint64_t crc_config_polynomial,
+								uint8_t crc_config_reflect_input,
+								uint8_t crc_config_reflect_output )
+{
+	uint8_t data_array [1031];
+	int32_t data_len, data_offset;
+	uint8_t reflected = (crc_config_reflect_input == 1);
+	uint64_t expected_crc;
+
+	fill_crc_test_data(data_array, sizeof(data_array), 0xC2B2AE35);
+
+	generate_crc64_slicing_tables(crc_config_polynomial);
+
+	for (data_offset = 0; data_offset < 4; data_offset++)
+	{
+		for (data_len = 0; data_len < (int32_t)sizeof(data_array) - data_offset; data_len += 37)
+		{
+			expected_crc = update_crc64_bitwise(crc_config_polynomial,reflected ? reflect(crc_config_initial_value,CRC_WIDTH_64) : crc_config_initial_value,
+												data_array + data_offset,(size_t)data_len,reflected);
+			if(reflected != (crc_config_reflect_output == 1))
+			{
+				expected_crc = reflect(expected_crc,CRC_WIDTH_64);
+			}
+			expected_crc ^= crc_config_final_xor_value;
+
+			if( expected_crc != calculate_crc64(data_array + data_offset,data_len,crc_config_initial_value,crc_config_final_xor_value,crc_config_polynomial,crc_config_reflect_input,crc_config_reflect_output) ||
+				expected_crc != calculate_crc64_slicing(data_array + data_offset,data_len,crc_config_initial_value,crc_config_final_xor_value,crc_config_polynomial,crc_config_reflect_input,crc_config_reflect_output) )
+			{
+				printf("crc64 engine mismatch, poly 0x%016llX, len %d, offset %d\n",(unsigned long long)crc_config_polynomial,data_len,data_offset);
+				return -1;
+			}
+		}
+	}
+
+	return 1; // ok.
+}
+#endif // #ifdef USE_SLICING_FOR_CRC_64
+
+
+int check_crc_64_algo()
+{
+	// no reflection
+	// CRC-64/ECMA-182 : width=64 poly=0x42f0e1eba9ea3693 init=0x0000000000000000 refin=false refout=false xorout=0x0000000000000000 check=0x6c40df5f0b497347 name="CRC-64/ECMA-182"
+#ifdef USE_TABLE_FOR_CRC_64
+	generate_crc64_table(0x42F0E1EBA9EA3693); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_64
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_64
+	generate_crc64_nibble_table(0x42F0E1EBA9EA3693);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_64
+	if( 0x6C40DF5F0B497347 != calculate_crc64((uint8_t*)"123456789",9,0x0000000000000000,0x0000000000000000,0x42F0E1EBA9EA3693,0,0) )
+	{
+		printf ("CRC-64/ECMA-182 reference check failed!\n\n");
+		return -1;
+	}
+
+	// no reflection, init and xor-out
+	// CRC-64/WE : width=64 poly=0x42f0e1eba9ea3693 init=0xffffffffffffffff refin=false refout=false xorout=0xffffffffffffffff check=0x62ec59e3f1a4f00a name="CRC-64/WE"
+	if( 0x62EC59E3F1A4F00A != calculate_crc64((uint8_t*)"123456789",9,0xFFFFFFFFFFFFFFFF,0xFFFFFFFFFFFFFFFF,0x42F0E1EBA9EA3693,0,0) )
+	{
+		printf ("CRC-64/WE reference check failed!\n\n");
+		return -1;
+	}
+
+	// reflect input data and output crc
+	// CRC-64/XZ : width=64 poly=0x42f0e1eba9ea3693 init=0xffffffffffffffff refin=true refout=true xorout=0xffffffffffffffff check=0x995dc9bbdf1939fa name="CRC-64/XZ"
+	if( 0x995DC9BBDF1939FA != calculate_crc64((uint8_t*)"123456789",9,0xFFFFFFFFFFFFFFFF,0xFFFFFFFFFFFFFFFF,0x42F0E1EBA9EA3693,1,1) )
+	{
+		printf ("CRC-64/XZ reference check failed!\n\n");
+		return -1;
+	}
+
+	// reflect input data and output crc, sparse polynomial
+	// CRC-64/GO-ISO : width=64 poly=0x000000000000001b init=0xffffffffffffffff refin=true refout=true xorout=0xffffffffffffffff check=0xb90956c775a41001 name="CRC-64/GO-ISO"
+#ifdef USE_TABLE_FOR_CRC_64
+	generate_crc64_table(0x000000000000001B); // required if testing table based implementation.
+#endif // USE_TABLE_FOR_CRC_64
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_64
+	generate_crc64_nibble_table(0x000000000000001B);
+#endif // USE_NIBBLE_TABLE_FOR_CRC_64
+	if( 0xB90956C775A41001 != calculate_crc64((uint8_t*)"123456789",9,0xFFFFFFFFFFFFFFFF,0xFFFFFFFFFFFFFFFF,0x000000000000001B,1,1) )
+	{
+		printf ("CRC-64/GO-ISO reference check failed!\n\n");
+		return -1;
+	}
+
+
+#ifdef USE_SLICING_FOR_CRC_64
+	// slicing-by-8 and clmul folding against the bitwise loop, both register directions.
+	if( check_crc64_slicing_engine(0xFFFFFFFFFFFFFFFF,0xFFFFFFFFFFFFFFFF,0x42F0E1EBA9EA3693,1,1) != 1 )
+	{
+		printf ("CRC-64/XZ engine check failed!\n\n");
+		return -1;
+	}
+	if( check_crc64_slicing_engine(0x0000000000000000,0x0000000000000000,0x42F0E1EBA9EA3693,0,0) != 1 )
+	{
+		printf ("CRC-64/ECMA-182 engine check failed!\n\n");
+		return -1;
+	}
+	if( check_crc64_slicing_engine(0xFFFFFFFFFFFFFFFF,0xFFFFFFFFFFFFFFFF,0x000000000000001B,1,1) != 1 ||
+		check_crc64_slicing_engine(0xFFFFFFFFFFFFFFFF,0x0000000000000000,0x000000000000001B,0,0) != 1 )
+	{
+		printf ("CRC-64/GO-ISO engine check failed!\n\n");
+		return -1;
+	}
+#endif // USE_SLICING_FOR_CRC_64
+
+
+	return 1; // ok.
+}
+///////////////////////////////////////////////////////////////////		CRC64 FUNCTIONS --	///////////////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////		SPECIALIZED FUNCTIONS ++	///////////////////////////////////////////////////////////////////
+#ifdef USE_SPECIALIZED_MODELS
+// 8 bytes as one word, first byte lowest (reflected registers) or highest (normal ones). gcc makes one load of each.
+static CRC_FORCE_INLINE uint64_t crc_load_le64(const uint8_t* byte_data)
+{
+	return	(uint64_t)byte_data[0] | ((uint64_t)byte_data[1] << 8) | ((uint64_t)byte_data[2] << 16) | ((uint64_t)byte_data[3] << 24) |
+			((uint64_t)byte_data[4] << 32) | ((uint64_t)byte_data[5] << 40) | ((uint64_t)byte_data[6] << 48) | ((uint64_t)byte_data[7] << 56);
+}
+
+
+static CRC_FORCE_INLINE uint64_t crc_load_be64(const uint8_t* byte_data)
+{
+	return	((uint64_t)byte_data[0] << 56) | ((uint64_t)byte_data[1] << 48) | ((uint64_t)byte_data[2] << 40) | ((uint64_t)byte_data[3] << 32) |
+			((uint64_t)byte_data[4] << 24) | ((uint64_t)byte_data[5] << 16) | ((uint64_t)byte_data[6] << 8) | (uint64_t)byte_data[7];
+}
+
+
+// the catalogue models with build time tables, see CRC_CONST_TABLES_MODELS.
+CRC_SPECIALIZE(crc8_smbus,			uint8_t,	8,	crc_const_table_8_07,							0,	0x00,				0x00)				// CRC-8
+CRC_SPECIALIZE(crc8_darc,			uint8_t,	8,	crc_const_table_8_39_reflected,					1,	0x00,				0x00)				// CRC-8/DARC
+CRC_SPECIALIZE(crc16_ccitt_false,	uint16_t,	16,	crc_const_table_16_1021,						0,	0xFFFF,				0x0000)				// CRC-16/CCITT-FALSE
+CRC_SPECIALIZE(crc16_arc,			uint16_t,	16,	crc_const_table_16_8005_reflected,				1,	0x0000,				0x0000)				// ARC
+CRC_SPECIALIZE(crc32_ieee,			uint32_t,	32,	crc_const_table_32_04C11DB7_reflected,			1,	0xFFFFFFFF,			0xFFFFFFFF)			// CRC-32
+CRC_SPECIALIZE(crc32_bzip2,			uint32_t,	32,	crc_const_table_32_04C11DB7,					0,	0xFFFFFFFF,			0xFFFFFFFF)			// CRC-32/BZIP2
+CRC_SPECIALIZE(crc64_xz,			uint64_t,	64,	crc_const_table_64_42F0E1EBA9EA3693_reflected,	1,	0xFFFFFFFFFFFFFFFF,	0xFFFFFFFFFFFFFFFF)	// CRC-64/XZ
+
+// CRC-32C. built for a cpu that has the crc32 instruction (-msse4.2, or a -march that has it), the instruction is used
+// straight, with no cpuid test per call; else the table like the others.
+#if defined(USE_HW_FOR_CRC_32C) && defined(__SSE4_2__)
+static CRC_FORCE_INLINE uint32_t crc32c_update(uint32_t crc_register, const uint8_t* byte_data, size_t data_len)
+{
+	uint64_t long_register = crc_register, data_word;
+
+	CRC_UNROLL_8
+	for (; data_len >= 8; data_len -= 8, byte_data += 8)
+	{
+		memcpy(&data_word, byte_data, 8);
+		long_register = _mm_crc32_u64(long_register, data_word);
+	}
+	crc_register = (uint32_t)long_register;
+
+	CRC_UNROLL_8
+	for (; data_len > 0; data_len--, byte_data++)
+	{
+		crc_register = _mm_crc32_u8(crc_register, *byte_data);
+	}
+
+	return crc_register;
+}
+#else
+CRC_SPECIALIZE_UPDATE(crc32c,		uint32_t,	32,	crc_const_table_32_1EDC6F41_reflected,			1)
+#endif // USE_HW_FOR_CRC_32C && __SSE4_2__
+CRC_SPECIALIZE_WRAPPERS(crc32c,		uint32_t,	0xFFFFFFFF,	0xFFFFFFFF)
+#endif // USE_SPECIALIZED_MODELS
+///////////////////////////////////////////////////////////////////		SPECIALIZED FUNCTIONS --	///////////////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////		MODEL FUNCTIONS ++	///////////////////////////////////////////////////////////////////
+// the table registry: one entry per (width, polynomial, direction), so e.g. CRC-32, JAMCRC (reflected) and BZIP2, MPEG-2, POSIX
+// (normal) need two entries between the five of them. entries are never freed, models keep pointers to them.
+static pthread_mutex_t crc_tables_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static crc_tables_t* crc_tables_registry = NULL;
+
+
+static void set_crc_table_entry(void* table_memory, uint8_t width, uint16_t entry_index, crc_value_t crc_value)
+{
+	switch (width)
+	{
+		case CRC_WIDTH_8:	((uint8_t*)table_memory)[entry_index] = (uint8_t)crc_value;		break;
+		case CRC_WIDTH_16:	((uint16_t*)table_memory)[entry_index] = (uint16_t)crc_value;	break;
+		case CRC_WIDTH_32:	((uint32_t*)table_memory)[entry_index] = (uint32_t)crc_value;	break;
+		default:			((uint64_t*)table_memory)[entry_index] = crc_value;				break;
+	}
+}
+
+
+static crc_value_t get_crc_table_entry(const void* table_memory, uint8_t width, uint16_t entry_index)
+{
+	switch (width)
+	{
+		case CRC_WIDTH_8:	return ((const uint8_t*)table_memory)[entry_index];
+		case CRC_WIDTH_16:	return ((const uint16_t*)table_memory)[entry_index];
+		case CRC_WIDTH_32:	return ((const uint32_t*)table_memory)[entry_index];
+		default:			return ((const uint64_t*)table_memory)[entry_index];
+	}
+}
+
+
+// builds one registry entry: same tables as generate_crc*_table() / generate_crc*_slicing_tables(), but for a single direction,
+// into private, cache line aligned memory instead of the globals.
+// fills 'slices' 256 entry tables for (width, polynomial, direction) into table_memory: the byte table, then every
+// slice derived from the one before by pushing one more zero byte through it.
+static void fill_crc_tables(void* table_memory, uint8_t width, crc_value_t polynomial, uint8_t reflected, uint8_t slices)
+{
+	crc_value_t crc_value;
+	crc_value_t reflected_polynomial = reflect(polynomial,width);
+	uint16_t byte_value;
+	uint8_t bit_index, slice_index;
+
+	for (byte_value = 0; byte_value < 256; byte_value++)
+	{
+		crc_value = reflected ? byte_value : ((crc_value_t)byte_value << (width - 8));
+
+		for (bit_index = 0; bit_index < 8; bit_index++)
+		{
+			if (reflected)
+			{
+				crc_value = (crc_value & 1) ? (crc_value >> 1) ^ reflected_polynomial : (crc_value >> 1);
+			}
+			else
+			{
+				crc_value = (crc_value & TOPBIT(width)) ? ((crc_value << 1) ^ polynomial) & CRC_MASK(width) : (crc_value << 1);
+			}
+		}
+		set_crc_table_entry(table_memory, width, byte_value, crc_value);
+	}
+
+	for (slice_index = 1; slice_index < slices; slice_index++)
+	{
+		for (byte_value = 0; byte_value < 256; byte_value++)
+		{
+			crc_value = get_crc_table_entry(table_memory, width, (uint16_t)((slice_index - 1) * 256 + byte_value));
+
+			if (reflected)
+			{
+				crc_value = (crc_value >> 8) ^ get_crc_table_entry(table_memory, width, crc_value & 0xFF);
+			}
+			else
+			{
+				crc_value = ((crc_value << 8) & CRC_MASK(width)) ^ get_crc_table_entry(table_memory, width, (uint16_t)(crc_value >> (width - 8)));
+			}
+			set_crc_table_entry(table_memory, width, (uint16_t)(slice_index * 256 + byte_value), crc_value);
+		}
+	}
+}
+
+
+#ifdef USE_NIBBLE_TABLES
+// the 16 entry table for update_crc*_nibble(), one direction, same as generate_crc*_nibble_table().
+static void fill_crc_nibble_table(void* table_memory, uint8_t width, crc_value_t polynomial, uint8_t reflected)
+{
+	crc_value_t crc_value;
+	crc_value_t reflected_polynomial = reflect(polynomial,width);
+	uint16_t nibble_value;
+	uint8_t bit_index;
+
+	for (nibble_value = 0; nibble_value < 16; nibble_value++)
+	{
+		crc_value = reflected ? nibble_value : ((crc_value_t)nibble_value << (width - 4));
+
+		for (bit_index = 0; bit_index < 4; bit_index++)
+		{
+			if (reflected)
+			{
+				crc_value = (crc_value & 1) ? (crc_value >> 1) ^ reflected_polynomial : (crc_value >> 1);
+			}
+			else
+			{
+				crc_value = (crc_value & TOPBIT(width)) ? ((crc_value << 1) ^ polynomial) & CRC_MASK(width) : (crc_value << 1);
+			}
+		}
+		set_crc_table_entry(table_memory, width, nibble_value, crc_value);
+	}
+}
+#endif // USE_NIBBLE_TABLES
+
+
+#if defined(USE_CONST_TABLES) && !defined(CRICKEY_GENERATE_TABLES)
+// the build time tables for (width, polynomial, direction), if crickey_tables.h has them with the slice count we'd build.
+static const void* find_crc_const_tables(uint8_t width, crc_value_t polynomial, uint8_t reflected, uint8_t slices)
+{
+	size_t entry_index;
+
+	for (entry_index = 0; entry_index < sizeof(crc_const_tables) / sizeof(crc_const_tables[0]); entry_index++)
+	{
+		if (crc_const_tables[entry_index].width == width && crc_const_tables[entry_index].polynomial == polynomial &&
+			crc_const_tables[entry_index].reflected == reflected && crc_const_tables[entry_index].slices == slices)
+		{
+			return crc_const_tables[entry_index].table_memory;
+		}
+	}
+
+	return NULL;
+}
+#endif // USE_CONST_TABLES
+
+
+static crc_tables_t* build_crc_tables(uint8_t width, crc_value_t polynomial, uint8_t reflected)
+{
+	crc_tables_t* tables;
+	const void* const_table_memory = NULL;
+	uint8_t* table_memory = NULL;
+	crc_value_t crc_value;
+	uint8_t bit_index, power_index, slices, nibble_table;
+
+	switch (width)
+	{
+		case CRC_WIDTH_8:	slices = CRC_TABLE_SLICES_8;	nibble_table = CRC_NIBBLE_TABLE_8;		break;
+		case CRC_WIDTH_16:	slices = CRC_TABLE_SLICES_16;	nibble_table = CRC_NIBBLE_TABLE_16;		break;
+		case CRC_WIDTH_32:	slices = CRC_TABLE_SLICES_32;	nibble_table = CRC_NIBBLE_TABLE_32;		break;
+		case CRC_WIDTH_64:	slices = CRC_TABLE_SLICES_64;	nibble_table = CRC_NIBBLE_TABLE_64;		break;
+		default:			return NULL;
+	}
+
+	(void)nibble_table; // nothing to build without USE_NIBBLE_TABLES.
+
+	tables = calloc(1, sizeof(crc_tables_t));
+	if (tables == NULL)
+	{
+		return NULL;
+	}
+
+#if defined(USE_CONST_TABLES) && !defined(CRICKEY_GENERATE_TABLES)
+	if (slices > 0)
+	{
+		const_table_memory = find_crc_const_tables(width, polynomial, reflected, slices);
+	}
+#endif // USE_CONST_TABLES
+
+	if (slices > 0 && const_table_memory == NULL)
+	{
+		table_memory = malloc((size_t)slices * 256 * (width / 8) + CRC_CACHE_LINE_SIZE - 1);
+		if (table_memory == NULL)
+		{
+			free(tables);
+			return NULL;
+		}
+		table_memory = (uint8_t*)(((uintptr_t)table_memory + CRC_CACHE_LINE_SIZE - 1) & ~(uintptr_t)(CRC_CACHE_LINE_SIZE - 1));
+
+		fill_crc_tables(table_memory, width, polynomial, reflected, slices);
+		const_table_memory = table_memory;
+	}
+
+	tables->width = width;
+	tables->polynomial = polynomial;
+	tables->reflected = reflected;
+	tables->slices = slices;
+	tables->slicing.memory = const_table_memory;
+
+#ifdef USE_NIBBLE_TABLES
+	if (nibble_table)
+	{
+		fill_crc_nibble_table(&tables->nibble, width, polynomial, reflected);
+	}
+#endif // USE_NIBBLE_TABLES
+
+#ifdef USE_CLMUL_FOR_CRC
+	if (width == CRC_WIDTH_16 || width == CRC_WIDTH_32)
+	{
+		generate_crc_clmul_constants(&tables->clmul, (uint32_t)polynomial, width, reflected);
+	}
+	else if (width == CRC_WIDTH_64)
+	{
+		generate_crc_clmul64_constants(&tables->clmul64, polynomial, reflected);
+	}
+#endif // USE_CLMUL_FOR_CRC
+
+	// x^8 mod P by eight shift-and-reduce steps from x^0, then keep squaring: x^(8*2^k) mod P.
+	crc_value = 1;
+	for (bit_index = 0; bit_index < 8; bit_index++)
+	{
+		crc_value = (crc_value & TOPBIT(width)) ? ((crc_value << 1) ^ polynomial) & CRC_MASK(width) : (crc_value << 1);
+	}
+	for (power_index = 0; power_index < 64; power_index++)
+	{
+		tables->xpow8n_powers[power_index] = crc_value;
+		crc_value = multiply_mod_crc(crc_value, crc_value, polynomial, width);
+	}
+
+	return tables;
+}
+
+
+// returns the shared tables for (width, polynomial, direction), building them on first use. thread safe.
+// NULL if the width is not supported or memory ran out, the model engines fall back to the bitwise loop then.
+const crc_tables_t* crc_tables_lookup(uint8_t width, crc_value_t polynomial, uint8_t reflected)
+{
+	crc_tables_t* tables;
+
+	polynomial &= CRC_MASK(width);
+	reflected = (reflected == 1);
+
+	pthread_mutex_lock(&crc_tables_registry_lock);
+
+	for (tables = crc_tables_registry; tables != NULL; tables = tables->next)
+	{
+		if (tables->width == width && tables->polynomial == polynomial && tables->reflected == reflected)
+		{
+			break;
+		}
+	}
+
+	if (tables == NULL)
+	{
+		tables = build_crc_tables(width, polynomial, reflected);
+		if (tables != NULL)
+		{
+			tables->next = crc_tables_registry;
+			crc_tables_registry = tables;
+		}
+	}
+
+	pthread_mutex_unlock(&crc_tables_registry_lock);
+
+	return tables;
+}
+
+
+// the model's tables, looked up once and then cached in the model. racing threads all store the same pointer.
+const crc_tables_t* crc_model_tables(crc_model_t* model)
+{
+	const crc_tables_t* tables = __atomic_load_n(&model->tables, __ATOMIC_ACQUIRE);
+
+	if (tables == NULL)
+	{
+		tables = crc_tables_lookup(model->width, model->polynomial, model->reflect_input);
+		__atomic_store_n(&model->tables, tables, __ATOMIC_RELEASE);
+	}
+
+	return tables;
+}
+
+
+crc_model_t* crc_find_model(const char* name)
+{
+	size_t model_index;
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		if (strcmp(crc_catalogue[model_index].name, name) == 0)
+		{
+			return &crc_catalogue[model_index];
+		}
+	}
+
+	return NULL;
+}
+
+
+// the raw register a model starts from, in its input direction (see calculate_crc32()).
+crc_value_t crc_register_init(const crc_model_t* model)
+{
+	return (model->reflect_input == 1) ? (reflect(model->initial_value,model->width) & CRC_MASK(model->width)) : model->initial_value;
+}
+
+
+// raw register -> crc: back to the output direction, then the final xor.
+crc_value_t crc_register_final(const crc_model_t* model, crc_value_t calculated_crc)
+{
+	if ((model->reflect_input == 1) != (model->reflect_output == 1))
+	{
+		calculated_crc = reflect(calculated_crc,model->width) & CRC_MASK(model->width);
+	}
+
+	return calculated_crc ^ model->final_xor_value;
+}
+
+
+// can the engine run on these tables, in this build, on this cpu.
+int crc_engine_usable(crc_engine_t engine, const crc_tables_t* tables)
+{
+	uint8_t slicing_width;
+
+	if (tables == NULL)
+	{
+		return 0;
+	}
+
+	slicing_width = (tables->width == CRC_WIDTH_16 || tables->width == CRC_WIDTH_32);
+
+	switch (engine)
+	{
+		case CRC_ENGINE_BITWISE:	return 1;
+		case CRC_ENGINE_NIBBLE:		return (tables->width == CRC_WIDTH_8 && CRC_NIBBLE_TABLE_8) || (tables->width == CRC_WIDTH_16 && CRC_NIBBLE_TABLE_16) ||
+											(tables->width == CRC_WIDTH_32 && CRC_NIBBLE_TABLE_32) || (tables->width == CRC_WIDTH_64 && CRC_NIBBLE_TABLE_64);
+		case CRC_ENGINE_TABLE:		return tables->slices >= 1;
+		case CRC_ENGINE_SLICING_4:
+		case CRC_ENGINE_SLICING_16:	return slicing_width && tables->slices >= CRC_SLICES_16;
+		case CRC_ENGINE_SLICING_8:	return tables->slices >= CRC_SLICES_8 && (slicing_width || tables->width == CRC_WIDTH_64);
+#ifdef USE_CLMUL_FOR_CRC
+		case CRC_ENGINE_CLMUL:		return tables->slices >= 1 && tables->width != CRC_WIDTH_8 && crc_clmul_available();
+#endif // USE_CLMUL_FOR_CRC
+#ifdef USE_HW_FOR_CRC_32C
+		case CRC_ENGINE_HW:			return tables->width == CRC_WIDTH_32 && tables->reflected && tables->polynomial == CRC_32C_POLYNOMIAL && crc32c_hw_available();
+#endif // USE_HW_FOR_CRC_32C
+		default:					return 0;
+	}
+}
+
+
+// runs the raw register over the data with one given engine, straight on the engine functions. the engine has to be
+// usable on the tables (crc_engine_usable()), CRC_ENGINE_AUTO isn't an engine here.
+crc_value_t crc_engine_update(crc_engine_t engine, const crc_tables_t* tables, crc_value_t crc_register, const uint8_t* byte_data, size_t data_len)
+{
+	uint8_t reflected = tables->reflected;
+	uint8_t slices = (engine == CRC_ENGINE_SLICING_4) ? CRC_SLICES_4 : (engine == CRC_ENGINE_SLICING_8) ? CRC_SLICES_8 : (engine == CRC_ENGINE_SLICING_16) ? CRC_SLICES_16 : 1;
+
+	(void)slices; // only the slicing engines look at it, and those can all be compiled out.
+
+	switch (engine)
+	{
+		case CRC_ENGINE_BITWISE:
+			switch (tables->width)
+			{
+				case CRC_WIDTH_8:	return update_crc8_bitwise((uint8_t)tables->polynomial,(uint8_t)crc_register,byte_data,data_len,reflected);
+				case CRC_WIDTH_16:	return update_crc16_bitwise((uint16_t)tables->polynomial,(uint16_t)crc_register,byte_data,data_len,reflected);
+				case CRC_WIDTH_32:	return update_crc32_bitwise((uint32_t)tables->polynomial,(uint32_t)crc_register,byte_data,data_len,reflected);
+				default:			return update_crc64_bitwise(tables->polynomial,crc_register,byte_data,data_len,reflected);
+			}
+#ifdef USE_NIBBLE_TABLES
+		case CRC_ENGINE_NIBBLE:
+			switch (tables->width)
+			{
+#if CRC_NIBBLE_TABLE_8
+				case CRC_WIDTH_8:	return update_crc8_nibble(tables->nibble.crc8,(uint8_t)crc_register,byte_data,data_len,reflected);
+#endif // CRC_NIBBLE_TABLE_8
+#if CRC_NIBBLE_TABLE_16
+				case CRC_WIDTH_16:	return update_crc16_nibble(tables->nibble.crc16,(uint16_t)crc_register,byte_data,data_len,reflected);
+#endif // CRC_NIBBLE_TABLE_16
+#if CRC_NIBBLE_TABLE_32
+				case CRC_WIDTH_32:	return update_crc32_nibble(tables->nibble.crc32,(uint32_t)crc_register,byte_data,data_len,reflected);
+#endif // CRC_NIBBLE_TABLE_32
+#if CRC_NIBBLE_TABLE_64
+				case CRC_WIDTH_64:	return update_crc64_nibble(tables->nibble.crc64,crc_register,byte_data,data_len,reflected);
+#endif // CRC_NIBBLE_TABLE_64
+				default:			return crc_register;
+			}
+#endif // USE_NIBBLE_TABLES
+#ifdef USE_HW_FOR_CRC_32C
+		case CRC_ENGINE_HW:
+			return update_crc32c_hw((uint32_t)crc_register, byte_data, data_len);
+#endif // USE_HW_FOR_CRC_32C
+#ifdef USE_CLMUL_FOR_CRC
+		// from 16 bytes up, not CRC_CLMUL_MIN_LEN: where it stops paying is the tuner's (and the benchmark's) call.
+		case CRC_ENGINE_CLMUL:
+			if (data_len >= 16)
+			{
+				crc_register = (tables->width == CRC_WIDTH_64) ?	update_crc_clmul64(&tables->clmul64, crc_register, byte_data, data_len & ~(size_t)15) :
+																	update_crc_clmul(&tables->clmul, (uint32_t)crc_register, byte_data, data_len & ~(size_t)15);
+				byte_data += data_len & ~(size_t)15;
+				data_len &= 15;
+			}
+			break;
+#endif // USE_CLMUL_FOR_CRC
+		default:
+			break;
+	}
+
+	// the table engines, and the tail of clmul.
+	switch (tables->width)
+	{
+#if CRC_TABLE_SLICES_8 > 0
+		case CRC_WIDTH_8:	return update_crc8_table(tables->slicing.crc8[0], (uint8_t)crc_register, byte_data, data_len, reflected);
+#endif // CRC_TABLE_SLICES_8 > 0
+#if defined(USE_SLICING_FOR_CRC_16)
+		case CRC_WIDTH_16:	return update_crc16_sliced(tables->slicing.crc16, (uint16_t)crc_register, byte_data, data_len, slices, reflected);
+#elif defined(USE_TABLE_FOR_CRC_16)
+		case CRC_WIDTH_16:	return update_crc16_table(tables->slicing.crc16[0], (uint16_t)crc_register, byte_data, data_len, reflected);
+#endif // USE_SLICING_FOR_CRC_16
+#if defined(USE_SLICING_FOR_CRC_32)
+		case CRC_WIDTH_32:	return update_crc32_sliced(tables->slicing.crc32, (uint32_t)crc_register, byte_data, data_len, slices, reflected);
+#elif defined(USE_TABLE_FOR_CRC_32)
+		case CRC_WIDTH_32:	return update_crc32_table(tables->slicing.crc32[0], (uint32_t)crc_register, byte_data, data_len, reflected);
+#endif // USE_SLICING_FOR_CRC_32
+#if defined(USE_SLICING_FOR_CRC_64)
+		case CRC_WIDTH_64:	return update_crc64_sliced(tables->slicing.crc64, crc_register, byte_data, data_len, slices, reflected);
+#elif defined(USE_TABLE_FOR_CRC_64)
+		case CRC_WIDTH_64:	return update_crc64_table(tables->slicing.crc64[0], crc_register, byte_data, data_len, reflected);
+#endif // USE_SLICING_FOR_CRC_64
+		default:			return crc_register;
+	}
+}
+
+
+#ifdef USE_ENGINE_TUNING
+// size class of a message, see CRC_TUNE_BUCKETS: floor(log4(data_len)), capped.
+static inline uint8_t crc_tune_bucket(size_t data_len)
+{
+	uint8_t bucket = (uint8_t)((63 - __builtin_clzll((unsigned long long)data_len | 1)) / 2);
+
+	return (bucket < CRC_TUNE_BUCKETS) ? bucket : (CRC_TUNE_BUCKETS - 1);
+}
+#endif // USE_ENGINE_TUNING
+
+
+// runs the raw register over the data with the best engine this build and cpu have for the model: the tuned one for the
+// size class if crc_tune() ran, else CRC-32C instruction, then PCLMULQDQ folding for the bulk, then slicing / byte table,
+// then the nibble table, then the bitwise loop.
+crc_value_t crc_update_register(crc_model_t* model, crc_value_t calculated_crc, const uint8_t* byte_data, size_t data_len)
+{
+	const crc_tables_t* tables = NULL;
+	uint8_t reflected = (model->reflect_input == 1);
+#ifdef USE_ENGINE_TUNING
+	uint8_t tuned_engine;
+
+	tables = crc_model_tables(model);
+	if (tables != NULL)
+	{
+		tuned_engine = __atomic_load_n(&tables->tuned_engines[crc_tune_bucket(data_len)], __ATOMIC_RELAXED);
+		if (tuned_engine != CRC_ENGINE_AUTO)
+		{
+			return crc_engine_update((crc_engine_t)tuned_engine, tables, calculated_crc, byte_data, data_len);
+		}
+	}
+#endif // USE_ENGINE_TUNING
+
+	(void)tables; // only the table engines look at it, and those can all be compiled out.
+
+	switch (model->width)
+	{
+		case CRC_WIDTH_8:
+#if CRC_TABLE_SLICES_8 > 0
+			tables = crc_model_tables(model);
+			if (tables != NULL)
+			{
+				return update_crc8_table(tables->slicing.crc8[0],(uint8_t)calculated_crc,byte_data,data_len,reflected);
+			}
+#elif CRC_NIBBLE_TABLE_8
+			tables = crc_model_tables(model);
+			if (tables != NULL)
+			{
+				return update_crc8_nibble(tables->nibble.crc8,(uint8_t)calculated_crc,byte_data,data_len,reflected);
+			}
+#endif // CRC_TABLE_SLICES_8 > 0
+			return update_crc8_bitwise((uint8_t)model->polynomial,(uint8_t)calculated_crc,byte_data,data_len,reflected);
+
+		case CRC_WIDTH_16:
+#if CRC_TABLE_SLICES_16 > 0
+			tables = crc_model_tables(model);
+#ifdef USE_CLMUL_FOR_CRC_16
+			if (tables != NULL && data_len >= CRC_CLMUL_MIN_LEN && crc_clmul_available())
+			{
+				calculated_crc = update_crc_clmul(&tables->clmul,calculated_crc,byte_data,data_len & ~(size_t)15);
+				byte_data += data_len & ~(size_t)15;
+				data_len &= 15;
+			}
+#endif // USE_CLMUL_FOR_CRC_16
+#if defined(USE_SLICING_FOR_CRC_16)
+			if (tables != NULL)
+			{
+				return update_crc16_sliced(tables->slicing.crc16,(uint16_t)calculated_crc,byte_data,data_len,CRC_MODEL_SLICES,reflected);
+			}
+#elif defined(USE_TABLE_FOR_CRC_16)
+			if (tables != NULL)
+			{
+				return update_crc16_table(tables->slicing.crc16[0],(uint16_t)calculated_crc,byte_data,data_len,reflected);
+			}
+#endif // USE_SLICING_FOR_CRC_16
+#elif CRC_NIBBLE_TABLE_16
+			tables = crc_model_tables(model);
+			if (tables != NULL)
+			{
+				return update_crc16_nibble(tables->nibble.crc16,(uint16_t)calculated_crc,byte_data,data_len,reflected);
+			}
+#endif // CRC_TABLE_SLICES_16 > 0
+			return update_crc16_bitwise((uint16_t)model->polynomial,(uint16_t)calculated_crc,byte_data,data_len,reflected);
+
+		case CRC_WIDTH_32:
+#ifdef USE_HW_FOR_CRC_32C
+			if (reflected && model->polynomial == CRC_32C_POLYNOMIAL && crc32c_hw_available())
+			{
+				return update_crc32c_hw((uint32_t)calculated_crc,byte_data,data_len);
+			}
+#endif // USE_HW_FOR_CRC_32C
+#if CRC_TABLE_SLICES_32 > 0
+			tables = crc_model_tables(model);
+#ifdef USE_CLMUL_FOR_CRC_32
+			if (tables != NULL && data_len >= CRC_CLMUL_MIN_LEN && crc_clmul_available())
+			{
+				calculated_crc = update_crc_clmul(&tables->clmul,calculated_crc,byte_data,data_len & ~(size_t)15);
+				byte_data += data_len & ~(size_t)15;
+				data_len &= 15;
+			}
+#endif // USE_CLMUL_FOR_CRC_32
+#if defined(USE_SLICING_FOR_CRC_32)
+			if (tables != NULL)
+			{
+				return update_crc32_sliced(tables->slicing.crc32,(uint32_t)calculated_crc,byte_data,data_len,CRC_MODEL_SLICES,reflected);
+			}
+#elif defined(USE_TABLE_FOR_CRC_32)
+			if (tables != NULL)
+			{
+				return update_crc32_table(tables->slicing.crc32[0],(uint32_t)calculated_crc,byte_data,data_len,reflected);
+			}
+#endif // USE_SLICING_FOR_CRC_32
+#elif CRC_NIBBLE_TABLE_32
+			tables = crc_model_tables(model);
+			if (tables != NULL)
+			{
+				return update_crc32_nibble(tables->nibble.crc32,(uint32_t)calculated_crc,byte_data,data_len,reflected);
+			}
+#endif // CRC_TABLE_SLICES_32 > 0
+			return update_crc32_bitwise((uint32_t)model->polynomial,(uint32_t)calculated_crc,byte_data,data_len,reflected);
+
+		case CRC_WIDTH_64:
+#if CRC_TABLE_SLICES_64 > 0
+			tables = crc_model_tables(model);
+#ifdef USE_CLMUL_FOR_CRC_64
+			if (tables != NULL && data_len >= CRC_CLMUL_MIN_LEN && crc_clmul_available())
+			{
+				calculated_crc = update_crc_clmul64(&tables->clmul64,calculated_crc,byte_data,data_len & ~(size_t)15);
+				byte_data += data_len & ~(size_t)15;
+				data_len &= 15;
+			}
+#endif // USE_CLMUL_FOR_CRC_64
+#if defined(USE_SLICING_FOR_CRC_64)
+			if (tables != NULL)
+			{
+				return update_crc64_sliced(tables->slicing.crc64,calculated_crc,byte_data,data_len,CRC_SLICES_8,reflected);
+			}
+#elif defined(USE_TABLE_FOR_CRC_64)
+			if (tables != NULL)
+			{
+				return update_crc64_table(tables->slicing.crc64[0],calculated_crc,byte_data,data_len,reflected);
+			}
+#endif // USE_SLICING_FOR_CRC_64
+#elif CRC_NIBBLE_TABLE_64
+			tables = crc_model_tables(model);
+			if (tables != NULL)
+			{
+				return update_crc64_nibble(tables->nibble.crc64,calculated_crc,byte_data,data_len,reflected);
+			}
+#endif // CRC_TABLE_SLICES_64 > 0
+			return update_crc64_bitwise(model->polynomial,calculated_crc,byte_data,data_len,reflected);
+
+		default:
+			return calculated_crc;
+	}
+}
+
+
+// one-shot crc of a buffer for any model. thread safe, no table setup needed.
+crc_value_t crc_calculate(crc_model_t* model, const uint8_t* byte_data, size_t data_len)
+{
+	return crc_register_final(model, crc_update_register(model, crc_register_init(model), byte_data, data_len));
+}
+
+
+// same, straight from the definition (update_crc*_bitwise()), the reference for cross-checking every other engine.
+crc_value_t crc_calculate_bitwise(const crc_model_t* model, const uint8_t* byte_data, size_t data_len)
+{
+	crc_value_t calculated_crc = crc_register_init(model);
+	uint8_t reflected = (model->reflect_input == 1);
+
+	switch (model->width)
+	{
+		case CRC_WIDTH_8:	calculated_crc = update_crc8_bitwise((uint8_t)model->polynomial,(uint8_t)calculated_crc,byte_data,data_len,reflected);		break;
+		case CRC_WIDTH_16:	calculated_crc = update_crc16_bitwise((uint16_t)model->polynomial,(uint16_t)calculated_crc,byte_data,data_len,reflected);	break;
+		case CRC_WIDTH_32:	calculated_crc = update_crc32_bitwise((uint32_t)model->polynomial,(uint32_t)calculated_crc,byte_data,data_len,reflected);	break;
+		case CRC_WIDTH_64:	calculated_crc = update_crc64_bitwise(model->polynomial,calculated_crc,byte_data,data_len,reflected);						break;
+		default:			break;
+	}
+
+	return crc_register_final(model, calculated_crc);
+}
+
+
+void crc_init(crc_context_t* context, crc_model_t* model)
+{
+	context->model = model;
+	context->crc_register = crc_register_init(model);
+	context->data_len = 0;
+}
+
+
+// the register carries everything there is to know about the data so far, so chunks can end anywhere,
+// and the result is the same as one crc_calculate() over all of them.
+void crc_update(crc_context_t* context, const void* byte_data, size_t data_len)
+{
+	context->crc_register = crc_update_register(context->model, context->crc_register, byte_data, data_len);
+	context->data_len += data_len;
+}
+
+
+// crc of everything so far. the context is left as is, so it can go on with more crc_update() after this.
+crc_value_t crc_final(const crc_context_t* context)
+{
+	return crc_register_final(context->model, context->crc_register);
+}
+
+
+// crc_update() over a scatter-gather list, in order, as if the segments were one buffer. nothing is flattened: at most
+// CRC_IOV_BLOCK_LEN - 1 bytes are copied at each edge of a long segment, and short segments are gathered whole.
+void crc_update_iov(crc_context_t* context, const crc_segment_t* segments, int segment_count)
+{
+	uint8_t stage_buffer [CRC_IOV_STAGE_LEN];
+	size_t staged_len = 0, segment_len, head_len, body_len;
+	const uint8_t* segment_data;
+	int segment_index;
+
+	for (segment_index = 0; segment_index < segment_count; segment_index++)
+	{
+		segment_data = segments[segment_index].base;
+		segment_len = segments[segment_index].len;
+
+		if (segment_len < CRC_IOV_MERGE_LEN)
+		{
+			if (segment_len > CRC_IOV_STAGE_LEN - staged_len)
+			{
+				crc_update(context, stage_buffer, staged_len);
+				staged_len = 0;
+			}
+			memcpy(stage_buffer + staged_len, segment_data, segment_len);
+			staged_len += segment_len;
+			continue;
+		}
+
+		// staged bytes plus the head of this segment make whole blocks, the rest of it goes as it is.
+		head_len = (CRC_IOV_BLOCK_LEN - staged_len % CRC_IOV_BLOCK_LEN) % CRC_IOV_BLOCK_LEN;
+		memcpy(stage_buffer + staged_len, segment_data, head_len);
+		crc_update(context, stage_buffer, staged_len + head_len);
+
+		body_len = (segment_len - head_len) & ~(size_t)(CRC_IOV_BLOCK_LEN - 1);
+		crc_update(context, segment_data + head_len, body_len);
+
+		staged_len = segment_len - head_len - body_len;
+		memcpy(stage_buffer, segment_data + head_len + body_len, staged_len);
+	}
+
+	crc_update(context, stage_buffer, staged_len);
+}
+
+
+// crc of the segments one after the other, the same as crc_calculate() over them flattened.
+crc_value_t crc_iov(crc_model_t* model, const crc_segment_t* segments, int segment_count)
+{
+	crc_context_t context;
+
+	crc_init(&context, model);
+	crc_update_iov(&context, segments, segment_count);
+
+	return crc_final(&context);
+}
+
+
+#ifdef USE_STREAMING_STORES
+// memcpy() with non-temporal stores: plain copies up to 16 byte alignment of the destination and for the tail.
+// the caller fences.
+static void crc_copy_streaming(uint8_t* destination, const uint8_t* source, size_t data_len)
+{
+	size_t head_len = (16 - ((uintptr_t)destination & 15)) & 15;
+
+	if (head_len > data_len)
+	{
+		head_len = data_len;
+	}
+	memcpy(destination, source, head_len);
+	destination += head_len;
+	source += head_len;
+	data_len -= head_len;
+
+	for (; data_len >= 64; data_len -= 64, destination += 64, source += 64)
+	{
+		__m128i block_0 = _mm_loadu_si128((const __m128i*)source);
+		__m128i block_1 = _mm_loadu_si128((const __m128i*)(source + 16));
+		__m128i block_2 = _mm_loadu_si128((const __m128i*)(source + 32));
+		__m128i block_3 = _mm_loadu_si128((const __m128i*)(source + 48));
+		_mm_stream_si128((__m128i*)destination, block_0);
+		_mm_stream_si128((__m128i*)(destination + 16), block_1);
+		_mm_stream_si128((__m128i*)(destination + 32), block_2);
+		_mm_stream_si128((__m128i*)(destination + 48), block_3);
+	}
+	for (; data_len >= 16; data_len -= 16, destination += 16, source += 16)
+	{
+		_mm_stream_si128((__m128i*)destination, _mm_loadu_si128((const __m128i*)source));
+	}
+
+	memcpy(destination, source, data_len);
+}
+#endif // USE_STREAMING_STORES
+
+
+// copies data_len bytes from source to destination (which must not overlap) and returns the crc of them, in one pass
+// over the source, with the given engine. CRC_ENGINE_AUTO, or an engine that isn't usable on the model in this build,
+// goes through crc_update_register() like crc_calculate().
+crc_value_t crc_copy_engine(crc_model_t* model, crc_engine_t engine, void* destination, const void* source, size_t data_len)
+{
+	const crc_tables_t* tables = crc_model_tables(model);
+	const uint8_t* source_data = source;
+	uint8_t* destination_data = destination;
+	crc_value_t crc_register = crc_register_init(model);
+	size_t block_len;
+#ifdef USE_STREAMING_STORES
+	uint8_t streaming = (data_len >= CRC_COPY_STREAM_LEN);
+#endif // USE_STREAMING_STORES
+
+	if (engine != CRC_ENGINE_AUTO && !crc_engine_usable(engine, tables))
+	{
+		engine = CRC_ENGINE_AUTO;
+	}
+
+	while (data_len > 0)
+	{
+		block_len = (data_len < CRC_COPY_BLOCK_LEN) ? data_len : CRC_COPY_BLOCK_LEN;
+
+#ifdef USE_STREAMING_STORES
+		if (streaming)
+		{
+			crc_copy_streaming(destination_data, source_data, block_len);
+		}
+		else
+#endif // USE_STREAMING_STORES
+		{
+			memcpy(destination_data, source_data, block_len);
+		}
+
+		// the copy pulled the block into L1.
+		crc_register = (engine == CRC_ENGINE_AUTO) ?	crc_update_register(model, crc_register, source_data, block_len) :
+														crc_engine_update(engine, tables, crc_register, source_data, block_len);
+
+		source_data += block_len;
+		destination_data += block_len;
+		data_len -= block_len;
+	}
+
+#ifdef USE_STREAMING_STORES
+	if (streaming)
+	{
+		_mm_sfence();
+	}
+#endif // USE_STREAMING_STORES
+
+	return crc_register_final(model, crc_register);
+}
+
+
+// memcpy() and crc_calculate() of the source in one pass, see crc_copy_engine().
+crc_value_t crc_copy(crc_model_t* model, void* destination, const void* source, size_t data_len)
+{
+	return crc_copy_engine(model, CRC_ENGINE_AUTO, destination, source, data_len);
+}
+
+
+// prints crickey_tables.h: the registry tables of every model in CRC_CONST_TABLES_MODELS as static const arrays, with the
+// slice counts this build uses. models with the same (width, polynomial, direction) get one table.
+// returns -1 if a model is not in the catalogue or memory ran out.
+int print_crc_const_tables()
+{
+	static const char* const model_names [] = CRC_CONST_TABLES_MODELS;
+	const crc_model_t* models [sizeof(model_names) / sizeof(model_names[0])];
+	uint8_t model_slices [sizeof(model_names) / sizeof(model_names[0])];
+	size_t model_index, other_index, entry_index, entry_count;
+	const crc_model_t* model;
+	uint8_t* table_memory;
+	uint8_t slices;
+
+	printf("// crickey_tables.h: build time crc tables, generated by crickey.c built with -DCRICKEY_GENERATE_TABLES. do not edit.\n");
+	printf("#ifndef CRICKEY_TABLES_H\n#define CRICKEY_TABLES_H\n\n");
+	printf("// models: ");
+	for (model_index = 0; model_index < sizeof(model_names) / sizeof(model_names[0]); model_index++)
+	{
+		models[model_index] = crc_find_model(model_names[model_index]);
+		if (models[model_index] == NULL)
+		{
+			fprintf(stderr, "%s: no such model in the catalogue\n", model_names[model_index]);
+			return -1;
+		}
+		printf("%s%s", (model_index == 0) ? "" : ", ", model_names[model_index]);
+
+		switch (models[model_index]->width)
+		{
+			case CRC_WIDTH_8:	model_slices[model_index] = CRC_TABLE_SLICES_8;		break;
+			case CRC_WIDTH_16:	model_slices[model_index] = CRC_TABLE_SLICES_16;	break;
+			case CRC_WIDTH_32:	model_slices[model_index] = CRC_TABLE_SLICES_32;	break;
+			default:			model_slices[model_index] = CRC_TABLE_SLICES_64;	break;
+		}
+	}
+	printf("\n\n");
+
+	for (model_index = 0, entry_count = 0; model_index < sizeof(model_names) / sizeof(model_names[0]); model_index++)
+	{
+		model = models[model_index];
+		slices = model_slices[model_index];
+
+		for (other_index = 0; other_index < model_index; other_index++)
+		{
+			if (models[other_index]->width == model->width && (models[other_index]->polynomial & CRC_MASK(model->width)) == (model->polynomial & CRC_MASK(model->width)) &&
+				(models[other_index]->reflect_input == 1) == (model->reflect_input == 1))
+			{
+				break;
+			}
+		}
+		if (other_index < model_index || slices == 0)
+		{
+			model_slices[model_index] = 0; // already printed, or no tables in this build.
+			continue;
+		}
+
+		table_memory = malloc((size_t)slices * 256 * (model->width / 8));
+		if (table_memory == NULL)
+		{
+			return -1;
+		}
+		fill_crc_tables(table_memory, model->width, model->polynomial & CRC_MASK(model->width), (model->reflect_input == 1), slices);
+
+		printf("static const uint%d_t crc_const_table_%d_%0*llX%s [%d][256] CRC_CONST_TABLE_ALIGNED =\n{\n",
+				model->width, model->width, model->width / 4, (unsigned long long)(model->polynomial & CRC_MASK(model->width)),
+				(model->reflect_input == 1) ? "_reflected" : "", slices);
+		for (entry_index = 0; entry_index < (size_t)slices * 256; entry_index++)
+		{
+			printf("%s0x%0*llX,%s", (entry_index % 256 == 0) ? "\t{\n\t\t" : (entry_index % 8 == 0) ? "\t\t" : "",
+					model->width / 4, (unsigned long long)get_crc_table_entry(table_memory, model->width, (uint16_t)entry_index),
+					(entry_index % 256 == 255) ? "\n\t},\n" : (entry_index % 8 == 7) ? "\n" : " ");
+		}
+		printf("};\n\n");
+
+		free(table_memory);
+		entry_count++;
+	}
+
+	printf("static const crc_const_tables_t crc_const_tables [] =\n{\n");
+	for (model_index = 0; model_index < sizeof(model_names) / sizeof(model_names[0]); model_index++)
+	{
+		model = models[model_index];
+		if (model_slices[model_index] == 0)
+		{
+			continue;
+		}
+
+		printf("\t{ %d, 0x%0*llX, %d, %d, crc_const_table_%d_%0*llX%s },\n",
+				model->width, model->width / 4, (unsigned long long)(model->polynomial & CRC_MASK(model->width)), (model->reflect_input == 1), model_slices[model_index],
+				model->width, model->width / 4, (unsigned long long)(model->polynomial & CRC_MASK(model->width)), (model->reflect_input == 1) ? "_reflected" : "");
+	}
+	if (entry_count == 0)
+	{
+		printf("\t{ 0, 0, 0, 0, NULL },\n");
+	}
+	printf("};\n\n#endif // CRICKEY_TABLES_H\n");
+
+	return 1;
+}
+
+
+// crc value -> raw register, the inverse of crc_register_final().
+crc_value_t crc_register_unfinal(const crc_model_t* model, crc_value_t calculated_crc)
+{
+	calculated_crc ^= model->final_xor_value;
+
+	if ((model->reflect_input == 1) != (model->reflect_output == 1))
+	{
+		calculated_crc = reflect(calculated_crc,model->width) & CRC_MASK(model->width);
+	}
+
+	return calculated_crc;
+}
+
+
+// x^(8*zero_len) mod P, natural order: one multiply per set bit of zero_len, using the precomputed powers.
+crc_value_t crc_xpow8n(crc_model_t* model, uint64_t zero_len)
+{
+	const crc_tables_t* tables = crc_model_tables(model);
+	crc_value_t polynomial = model->polynomial & CRC_MASK(model->width);
+	crc_value_t power = 1, square;
+	uint8_t power_index, bit_index;
+
+	if (tables != NULL)
+	{
+		for (power_index = 0; zero_len != 0; power_index++, zero_len >>= 1)
+		{
+			if (zero_len & 1)
+			{
+				power = multiply_mod_crc(power, tables->xpow8n_powers[power_index], polynomial, model->width);
+			}
+		}
+
+		return power;
+	}
+
+	// no registry entry (out of memory): same square-and-multiply, squaring on the go.
+	square = 1;
+	for (bit_index = 0; bit_index < 8; bit_index++)
+	{
+		square = (square & TOPBIT(model->width)) ? ((square << 1) ^ polynomial) & CRC_MASK(model->width) : (square << 1);
+	}
+	for (; zero_len != 0; zero_len >>= 1)
+	{
+		if (zero_len & 1)
+		{
+			power = multiply_mod_crc(power, square, polynomial, model->width);
+		}
+		square = multiply_mod_crc(square, square, polynomial, model->width);
+	}
+
+	return power;
+}
+
+
+// what running zero_len zero bytes through the raw register does, in O(log zero_len): register * x^(8*zero_len) mod P.
+// a reflected register is turned around for the multiply and back.
+crc_value_t crc_shift_register(crc_model_t* model, crc_value_t crc_register, uint64_t zero_len)
+{
+	uint8_t reflected = (model->reflect_input == 1);
+	crc_value_t polynomial = model->polynomial & CRC_MASK(model->width);
+
+	if (reflected)
+	{
+		crc_register = reflect(crc_register,model->width) & CRC_MASK(model->width);
+	}
+
+	crc_register = multiply_mod_crc(crc_register, crc_xpow8n(model, zero_len), polynomial, model->width);
+
+	if (reflected)
+	{
+		crc_register = reflect(crc_register,model->width) & CRC_MASK(model->width);
+	}
+
+	return crc_register;
+}
+
+
+// crc of (message || zero_len zero bytes), from the crc of the message alone.
+crc_value_t crc_extend_zeros(crc_model_t* model, crc_value_t calculated_crc, uint64_t zero_len)
+{
+	return crc_register_final(model, crc_shift_register(model, crc_register_unfinal(model, calculated_crc), zero_len));
+}
+
+
+// crc(A || B) from crc(A), crc(B) and len(B). the register is linear in (init, data), so:
+// register(A || B) = shift(register(A), len B) ^ register(B), where register(B) started from init instead of from
+// register(A); the init's own contribution is shift(init, len B) and gets cancelled out.
+crc_value_t crc_combine(crc_model_t* model, crc_value_t crc_a, crc_value_t crc_b, uint64_t len_b)
+{
+	crc_value_t register_a = crc_register_unfinal(model, crc_a);
+	crc_value_t register_b = crc_register_unfinal(model, crc_b);
+
+	return crc_register_final(model, crc_shift_register(model, register_a ^ crc_register_init(model), len_b) ^ register_b);
+}
+
+
+// crc_update() of zero_len zero bytes without the bytes: a zero run only shifts the register, x^(8 * zero_len) mod P,
+// in O(log zero_len). holes of sparse files go in this way.
+void crc_update_zeros(crc_context_t* context, uint64_t zero_len)
+{
+	context->crc_register = crc_shift_register(context->model, context->crc_register, zero_len);
+	context->data_len += zero_len;
+}
+
+
+// crc of a total_len byte message after the n bytes at offset changed from old_bytes to new_bytes, from its old crc,
+// without the rest of the message: O(n + log total_len). the register is linear in the data, so the change to it is
+// the register of (old ^ new) run from 0, shifted over the total_len - offset - n bytes after it; init and final xor cancel.
+// a patch that doesn't fit inside the message gives old_crc back.
+crc_value_t crc_patch(crc_model_t* model, crc_value_t old_crc, uint64_t total_len, uint64_t offset,
+						const uint8_t* old_bytes, const uint8_t* new_bytes, size_t n)
+{
+	uint8_t delta_array [256];
+	crc_value_t delta_register = 0;
+	size_t byte_index, chunk_len;
+
+	if (offset > total_len || n > total_len - offset)
+	{
+		return old_crc;
+	}
+
+	while (n > 0)
+	{
+		chunk_len = (n < sizeof(delta_array)) ? n : sizeof(delta_array);
+		for (byte_index = 0; byte_index < chunk_len; byte_index++)
+		{
+			delta_array[byte_index] = old_bytes[byte_index] ^ new_bytes[byte_index];
+		}
+		delta_register = crc_update_register(model, delta_register, delta_array, chunk_len);
+
+		old_bytes += chunk_len;
+		new_bytes += chunk_len;
+		offset += chunk_len;
+		n -= chunk_len;
+	}
+
+	return crc_register_final(model, crc_register_unfinal(model, old_crc) ^ crc_shift_register(model, delta_register, total_len - offset));
+}
+
+
+typedef struct
+{
+	crc_model_t* model;
+	const uint8_t* byte_data;
+	size_t data_len;
+	crc_value_t crc_register;				// chunk register, started from 0 (from the model init for the first chunk).
+} crc_parallel_chunk_t;
+
+
+static void* crc_parallel_chunk_thread(void* thread_argument)
+{
+	crc_parallel_chunk_t* chunk = thread_argument;
+
+	chunk->crc_register = crc_update_register(chunk->model, chunk->crc_register, chunk->byte_data, chunk->data_len);
+
+	return NULL;
+}
+
+
+// how many threads to spread data_len bytes over: thread_count, 0 meaning one per online cpu, at most CRC_PARALLEL_MAX_THREADS,
+// and no more than there are min_len pieces in data_len. always at least 1.
+uint8_t crc_parallel_thread_count(uint8_t thread_count, size_t data_len, size_t min_len)
+{
+	if (thread_count == 0)
+	{
+#ifdef _SC_NPROCESSORS_ONLN
+		long online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		thread_count = (online_cpus < 1) ? 1 : (online_cpus > CRC_PARALLEL_MAX_THREADS) ? CRC_PARALLEL_MAX_THREADS : (uint8_t)online_cpus;
+#else
+		thread_count = 4;
+#endif // _SC_NPROCESSORS_ONLN
+	}
+	if (thread_count > CRC_PARALLEL_MAX_THREADS)
+	{
+		thread_count = CRC_PARALLEL_MAX_THREADS;
+	}
+
+	if (data_len / min_len < thread_count)
+	{
+		thread_count = (data_len < min_len) ? 1 : (uint8_t)(data_len / min_len);
+	}
+
+	return thread_count;
+}
+
+
+// crc of one big buffer on several threads: every chunk runs the best engine on its own, from a zero register, and the
+// chunk registers are merged with crc_shift_register(), the same math as crc_combine(), nothing gets recomputed.
+// thread_count 0 means one thread per online cpu, min_len 0 means CRC_PARALLEL_MIN_LEN.
+// the calling thread does the first chunk itself, a thread that can't be started has its chunk done here as well.
+crc_value_t crc_calculate_parallel(crc_model_t* model, const uint8_t* byte_data, size_t data_len, uint8_t thread_count, size_t min_len)
+{
+	crc_parallel_chunk_t chunks [CRC_PARALLEL_MAX_THREADS];
+	pthread_t threads [CRC_PARALLEL_MAX_THREADS];
+	uint8_t thread_started [CRC_PARALLEL_MAX_THREADS];
+	size_t chunk_len, data_offset;
+	crc_value_t crc_register;
+	uint8_t chunk_count, chunk_index;
+
+	if (min_len == 0)
+	{
+		min_len = CRC_PARALLEL_MIN_LEN;
+	}
+	// a whole number of aligned pieces, or chunk_len below could round down to nothing.
+	min_len = (min_len + CRC_PARALLEL_CHUNK_ALIGN - 1) & ~(size_t)(CRC_PARALLEL_CHUNK_ALIGN - 1);
+
+	chunk_count = crc_parallel_thread_count(thread_count, data_len, min_len);
+	if (chunk_count <= 1)
+	{
+		return crc_calculate(model, byte_data, data_len);
+	}
+
+	// look the tables up once here, not in every thread.
+	(void)crc_model_tables(model);
+
+	chunk_len = (data_len / chunk_count) & ~(size_t)(CRC_PARALLEL_CHUNK_ALIGN - 1);
+	for (chunk_index = 0, data_offset = 0; chunk_index < chunk_count; chunk_index++, data_offset += chunk_len)
+	{
+		chunks[chunk_index].model = model;
+		chunks[chunk_index].byte_data = byte_data + data_offset;
+		chunks[chunk_index].data_len = (chunk_index == chunk_count - 1) ? data_len - data_offset : chunk_len;
+		chunks[chunk_index].crc_register = (chunk_index == 0) ? crc_register_init(model) : 0;
+
+		thread_started[chunk_index] = (chunk_index != 0) &&
+				(pthread_create(&threads[chunk_index], NULL, crc_parallel_chunk_thread, &chunks[chunk_index]) == 0);
+	}
+
+	for (chunk_index = 0; chunk_index < chunk_count; chunk_index++)
+	{
+		if (!thread_started[chunk_index])
+		{
+			crc_parallel_chunk_thread(&chunks[chunk_index]);
+		}
+	}
+
+	// register(A || B) = shift(register(A), len B) ^ register(B), chunk by chunk.
+	crc_register = chunks[0].crc_register;
+	for (chunk_index = 1; chunk_index < chunk_count; chunk_index++)
+	{
+		if (thread_started[chunk_index])
+		{
+			pthread_join(threads[chunk_index], NULL);
+		}
+
+		crc_register = crc_shift_register(model, crc_register, chunks[chunk_index].data_len) ^ chunks[chunk_index].crc_register;
+	}
+
+	return crc_register_final(model, crc_register);
+}
+
+
+// slicing-by-8 over the CRC_BATCH_LANES registers in lockstep, block_count 8 byte blocks each. the block is read as one 64 bit word
+// (little-endian for the reflected register, big-endian for the normal one) and the register xored into its first bytes,
+// which is the slicing-by-8 step for a 32 or 64 bit register: bytes past the register width are looked up as they are.
+// width and reflected are constants in every caller, so each (width, direction) gets its own branch-free loop.
+// the lanes are written out one by one: kept in an array, gcc leaves them in memory and every step waits on a store.
+static CRC_FORCE_INLINE void update_crc_batch_lanes(const void* slicing_table, crc_value_t lane_crc [CRC_BATCH_LANES], const uint8_t* lane_data [CRC_BATCH_LANES],
+													size_t block_count, const uint8_t width, const uint8_t reflected)
+{
+	crc_value_t crc_0 = lane_crc[0], crc_1 = lane_crc[1], crc_2 = lane_crc[2], crc_3 = lane_crc[3];
+	const uint8_t *data_0 = lane_data[0], *data_1 = lane_data[1], *data_2 = lane_data[2], *data_3 = lane_data[3];
+	uint64_t word_0, word_1, word_2, word_3;
+
+#define CRC_BATCH_ENTRY(slice, index)	((width == CRC_WIDTH_32) ? (crc_value_t)((const uint32_t (*)[256])slicing_table)[slice][index] : \
+																   ((const uint64_t (*)[256])slicing_table)[slice][index])
+#define CRC_BATCH_BYTE(word, slice, n)	CRC_BATCH_ENTRY(slice, ((word) >> (reflected ? 8 * (n) : 56 - 8 * (n))) & 0xFF)
+#define CRC_BATCH_STEP(crc, data, word)																												\
+	if (reflected)																																	\
+	{																																				\
+		word = (uint64_t)(data)[0] | ((uint64_t)(data)[1] << 8) | ((uint64_t)(data)[2] << 16) | ((uint64_t)(data)[3] << 24) |						\
+			   ((uint64_t)(data)[4] << 32) | ((uint64_t)(data)[5] << 40) | ((uint64_t)(data)[6] << 48) | ((uint64_t)(data)[7] << 56);					\
+		word ^= crc;																																\
+	}																																				\
+	else																																			\
+	{																																				\
+		word = ((uint64_t)(data)[0] << 56) | ((uint64_t)(data)[1] << 48) | ((uint64_t)(data)[2] << 40) | ((uint64_t)(data)[3] << 32) |				\
+			   ((uint64_t)(data)[4] << 24) | ((uint64_t)(data)[5] << 16) | ((uint64_t)(data)[6] << 8) | (uint64_t)(data)[7];							\
+		word ^= (uint64_t)crc << (64 - width);																										\
+	}																																				\
+	crc = CRC_BATCH_BYTE(word, 7, 0) ^ CRC_BATCH_BYTE(word, 6, 1) ^ CRC_BATCH_BYTE(word, 5, 2) ^ CRC_BATCH_BYTE(word, 4, 3) ^						\
+		  CRC_BATCH_BYTE(word, 3, 4) ^ CRC_BATCH_BYTE(word, 2, 5) ^ CRC_BATCH_BYTE(word, 1, 6) ^ CRC_BATCH_BYTE(word, 0, 7);						\
+	data += 8;
+
+	while (block_count-- > 0)
+	{
+		CRC_BATCH_STEP(crc_0, data_0, word_0)
+		CRC_BATCH_STEP(crc_1, data_1, word_1)
+		CRC_BATCH_STEP(crc_2, data_2, word_2)
+		CRC_BATCH_STEP(crc_3, data_3, word_3)
+	}
+
+	lane_crc[0] = crc_0;
+	lane_crc[1] = crc_1;
+	lane_crc[2] = crc_2;
+	lane_crc[3] = crc_3;
+
+#undef CRC_BATCH_STEP
+#undef CRC_BATCH_BYTE
+#undef CRC_BATCH_ENTRY
+}
+
+
+#ifdef USE_HW_FOR_CRC_32C
+// the same lockstep with the crc32 instruction: 4 lanes keep the 3 cycle latency chain busy.
+__attribute__((target("sse4.2")))
+static void update_crc32c_hw_batch_lanes(crc_value_t lane_crc [CRC_BATCH_LANES], const uint8_t* lane_data [CRC_BATCH_LANES], size_t block_count)
+{
+	uint64_t crc_0 = lane_crc[0], crc_1 = lane_crc[1], crc_2 = lane_crc[2], crc_3 = lane_crc[3];
+	const uint8_t *data_0 = lane_data[0], *data_1 = lane_data[1], *data_2 = lane_data[2], *data_3 = lane_data[3];
+	uint64_t data_word;
+	size_t block_index;
+
+	for (block_index = 0; block_index < block_count * 8; block_index += 8)
+	{
+		memcpy(&data_word, data_0 + block_index, 8);
+		crc_0 = _mm_crc32_u64(crc_0, data_word);
+		memcpy(&data_word, data_1 + block_index, 8);
+		crc_1 = _mm_crc32_u64(crc_1, data_word);
+		memcpy(&data_word, data_2 + block_index, 8);
+		crc_2 = _mm_crc32_u64(crc_2, data_word);
+		memcpy(&data_word, data_3 + block_index, 8);
+		crc_3 = _mm_crc32_u64(crc_3, data_word);
+	}
+
+	lane_crc[0] = crc_0;
+	lane_crc[1] = crc_1;
+	lane_crc[2] = crc_2;
+	lane_crc[3] = crc_3;
+}
+#endif // USE_HW_FOR_CRC_32C
+
+
+// raw registers of one group of CRC_BATCH_LANES messages: the common length in lockstep where a lane engine pays
+// (see CRC_BATCH_LANES), whatever each message has past that on its own.
+static void crc_update_batch_group(crc_model_t* model, const crc_tables_t* tables, crc_value_t init_register, const uint8_t* lane_data [CRC_BATCH_LANES],
+									const size_t lane_len [CRC_BATCH_LANES], crc_value_t lane_registers [CRC_BATCH_LANES])
+{
+	crc_value_t lane_crc [CRC_BATCH_LANES];
+	size_t common_len = lane_len[0], block_count = 0;
+	uint8_t lane_index, reflected = (model->reflect_input == 1), table_lanes;
+
+	for (lane_index = 0; lane_index < CRC_BATCH_LANES; lane_index++)
+	{
+		lane_crc[lane_index] = init_register;
+		if (lane_len[lane_index] < common_len)
+		{
+			common_len = lane_len[lane_index];
+		}
+	}
+
+	table_lanes = (tables != NULL && tables->slices >= CRC_SLICES_8 && model->width >= CRC_WIDTH_32);
+#ifdef USE_CLMUL_FOR_CRC
+	table_lanes = table_lanes && (common_len < CRC_CLMUL_MIN_LEN || !crc_clmul_available());
+#endif // USE_CLMUL_FOR_CRC
+
+#ifdef USE_HW_FOR_CRC_32C
+	if (model->width == CRC_WIDTH_32 && reflected && model->polynomial == CRC_32C_POLYNOMIAL && crc32c_hw_available())
+	{
+		block_count = common_len / 8;
+		update_crc32c_hw_batch_lanes(lane_crc, lane_data, block_count);
+	}
+	else
+#endif // USE_HW_FOR_CRC_32C
+	if (table_lanes)
+	{
+		block_count = common_len / 8;
+
+		switch (model->width | reflected)
+		{
+			case CRC_WIDTH_32:		update_crc_batch_lanes(tables->slicing.memory, lane_crc, lane_data, block_count, CRC_WIDTH_32, 0);	break;
+			case CRC_WIDTH_32 | 1:	update_crc_batch_lanes(tables->slicing.memory, lane_crc, lane_data, block_count, CRC_WIDTH_32, 1);	break;
+			case CRC_WIDTH_64:		update_crc_batch_lanes(tables->slicing.memory, lane_crc, lane_data, block_count, CRC_WIDTH_64, 0);	break;
+			default:				update_crc_batch_lanes(tables->slicing.memory, lane_crc, lane_data, block_count, CRC_WIDTH_64, 1);	break;
+		}
+	}
+
+	for (lane_index = 0; lane_index < CRC_BATCH_LANES; lane_index++)
+	{
+		lane_registers[lane_index] = crc_update_register(model, lane_crc[lane_index], lane_data[lane_index] + block_count * 8,
+															lane_len[lane_index] - block_count * 8);
+	}
+}
+
+
+// crcs of 'count' independent messages in one call, calculated_crcs[i] = crc_calculate(model, byte_data[i], data_len[i]).
+// the model setup is done once, and the messages go through CRC_BATCH_LANES at a time, see update_crc_batch_lanes().
+void crc_calculate_batch(crc_model_t* model, const uint8_t* const byte_data [], const size_t data_len [], size_t count, crc_value_t calculated_crcs [])
+{
+	const crc_tables_t* tables = crc_model_tables(model);
+	crc_value_t init_register = crc_register_init(model);
+	crc_value_t lane_registers [CRC_BATCH_LANES];
+	const uint8_t* lane_data [CRC_BATCH_LANES];
+	size_t lane_len [CRC_BATCH_LANES];
+	size_t message_index;
+	uint8_t lane_index;
+
+	for (message_index = 0; message_index + CRC_BATCH_LANES <= count; message_index += CRC_BATCH_LANES)
+	{
+		for (lane_index = 0; lane_index < CRC_BATCH_LANES; lane_index++)
+		{
+			lane_data[lane_index] = byte_data[message_index + lane_index];
+			lane_len[lane_index] = data_len[message_index + lane_index];
+		}
+		crc_update_batch_group(model, tables, init_register, lane_data, lane_len, lane_registers);
+
+		for (lane_index = 0; lane_index < CRC_BATCH_LANES; lane_index++)
+		{
+			calculated_crcs[message_index + lane_index] = crc_register_final(model, lane_registers[lane_index]);
+		}
+	}
+
+	for (; message_index < count; message_index++)
+	{
+		calculated_crcs[message_index] = crc_calculate(model, byte_data[message_index], data_len[message_index]);
+	}
+}
+
+
+// same, for messages packed back to back in one buffer: message i is packed_data[offsets[i] .. offsets[i+1]),
+// so offsets has count + 1 entries.
+void crc_calculate_packed(crc_model_t* model, const uint8_t* packed_data, const size_t offsets [], size_t count, crc_value_t calculated_crcs [])
+{
+	const crc_tables_t* tables = crc_model_tables(model);
+	crc_value_t init_register = crc_register_init(model);
+	crc_value_t lane_registers [CRC_BATCH_LANES];
+	const uint8_t* lane_data [CRC_BATCH_LANES];
+	size_t lane_len [CRC_BATCH_LANES];
+	size_t message_index;
+	uint8_t lane_index;
+
+	for (message_index = 0; message_index + CRC_BATCH_LANES <= count; message_index += CRC_BATCH_LANES)
+	{
+		for (lane_index = 0; lane_index < CRC_BATCH_LANES; lane_index++)
+		{
+			lane_data[lane_index] = packed_data + offsets[message_index + lane_index];
+			lane_len[lane_index] = offsets[message_index + lane_index + 1] - offsets[message_index + lane_index];
+		}
+		crc_update_batch_group(model, tables, init_register, lane_data, lane_len, lane_registers);
+
+		for (lane_index = 0; lane_index < CRC_BATCH_LANES; lane_index++)
+		{
+			calculated_crcs[message_index + lane_index] = crc_register_final(model, lane_registers[lane_index]);
+		}
+	}
+
+	for (; message_index < count; message_index++)
+	{
+		calculated_crcs[message_index] = crc_calculate(model, packed_data + offsets[message_index], offsets[message_index + 1] - offsets[message_index]);
+	}
+}
+
+
+typedef struct
+{
+	crc_model_t* model;
+	const uint8_t* byte_data;
+	size_t data_len;						// a whole number of blocks, but for the last range.
+	size_t block_len;
+	crc_value_t* block_crcs;
+	const crc_value_t (*shift_table) [256];	// shift by block_len, a table per register byte, or NULL.
+	crc_value_t range_register;				// what the range adds to the object register, from a zero register.
+} crc_blocks_range_t;
+
+
+// shift_table[k][b]: crc_shift_register() of byte value b at register byte k. any register is shifted by xoring the
+// entries of its bytes. each table is filled from the shifts of its 8 single bits.
+static void fill_crc_shift_table(crc_model_t* model, uint64_t shift_len, crc_value_t shift_table [8][256])
+{
+	uint8_t byte_index, bit_index;
+	uint16_t byte_value, low_bit;
+
+	for (byte_index = 0; byte_index < model->width / 8; byte_index++)
+	{
+		shift_table[byte_index][0] = 0;
+		for (bit_index = 0; bit_index < 8; bit_index++)
+		{
+			shift_table[byte_index][1 << bit_index] = crc_shift_register(model, (crc_value_t)1 << (8 * byte_index + bit_index), shift_len);
+		}
+		for (byte_value = 3; byte_value < 256; byte_value++)
+		{
+			low_bit = byte_value & (uint16_t)(~byte_value + 1);
+			if (byte_value != low_bit)
+			{
+				shift_table[byte_index][byte_value] = shift_table[byte_index][byte_value ^ low_bit] ^ shift_table[byte_index][low_bit];
+			}
+		}
+	}
+}
+
+
+static inline crc_value_t crc_shift_by_table(const crc_value_t shift_table [][256], crc_value_t crc_register, uint8_t width)
+{
+	crc_value_t shifted_register = 0;
+	uint8_t byte_index;
+
+	for (byte_index = 0; byte_index < width / 8; byte_index++)
+	{
+		shifted_register ^= shift_table[byte_index][(crc_register >> (8 * byte_index)) & 0xFF];
+	}
+
+	return shifted_register;
+}
+
+
+// the blocks of one range, CRC_BATCH_LANES at a time, each from the model init. the object register takes every
+// block in turn: register = shift(register ^ init, block len) ^ block register, which is shift(register, block len) ^
+// (block register ^ shift(init, block len)), so from a zero register the range comes out as one register to shift
+// into place later, like a crc_calculate_parallel() chunk.
+static void* crc_blocks_range_thread(void* thread_argument)
+{
+	crc_blocks_range_t* range = thread_argument;
+	crc_model_t* model = range->model;
+	const crc_tables_t* tables = crc_model_tables(model);
+	crc_value_t init_register = crc_register_init(model);
+	crc_value_t init_shift = crc_shift_register(model, init_register, range->block_len);
+	crc_value_t lane_registers [CRC_BATCH_LANES];
+	const uint8_t* lane_data [CRC_BATCH_LANES];
+	size_t lane_len [CRC_BATCH_LANES];
+	size_t block_count = (range->data_len + range->block_len - 1) / range->block_len, block_index, block_offset;
+	uint8_t lane_index, lane_count;
+
+	range->range_register = 0;
+
+	for (block_index = 0; block_index < block_count; block_index += lane_count)
+	{
+		lane_count = (block_count - block_index >= CRC_BATCH_LANES) ? CRC_BATCH_LANES : 1;
+
+		for (lane_index = 0; lane_index < lane_count; lane_index++)
+		{
+			block_offset = (block_index + lane_index) * range->block_len;
+			lane_data[lane_index] = range->byte_data + block_offset;
+			lane_len[lane_index] = (range->data_len - block_offset < range->block_len) ? range->data_len - block_offset : range->block_len;
+		}
+
+		if (lane_count == CRC_BATCH_LANES)
+		{
+			crc_update_batch_group(model, tables, init_register, lane_data, lane_len, lane_registers);
+		}
+		else
+		{
+			lane_registers[0] = crc_update_register(model, init_register, lane_data[0], lane_len[0]);
+		}
+
+		for (lane_index = 0; lane_index < lane_count; lane_index++)
+		{
+			range->block_crcs[block_index + lane_index] = crc_register_final(model, lane_registers[lane_index]);
+			if (lane_len[lane_index] == range->block_len)
+			{
+				range->range_register = ((range->shift_table != NULL) ?	crc_shift_by_table(range->shift_table, range->range_register, model->width) :
+																		crc_shift_register(model, range->range_register, range->block_len)) ^
+										lane_registers[lane_index] ^ init_shift;
+			}
+			else
+			{
+				range->range_register = crc_shift_register(model, range->range_register, lane_len[lane_index]) ^ lane_registers[lane_index] ^
+										crc_shift_register(model, init_register, lane_len[lane_index]);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+
+// per block crcs of a buffer cut into block_len blocks (the last one can be shorter), block_crcs[i] = crc_calculate()
+// of block i, and the crc of the whole buffer merged from the block registers in the same pass, not recomputed.
+// block_crcs needs room for (data_len + block_len - 1) / block_len entries, block_len 0 is one block of data_len.
+// the blocks are split over threads in ranges of at least CRC_PARALLEL_MIN_LEN, like crc_calculate_parallel() chunks,
+// thread_count 0 means one thread per online cpu.
+crc_value_t crc_calculate_blocks(crc_model_t* model, const uint8_t* byte_data, size_t data_len, size_t block_len, crc_value_t block_crcs [], uint8_t thread_count)
+{
+	crc_blocks_range_t ranges [CRC_PARALLEL_MAX_THREADS];
+	crc_value_t (*shift_table) [256] = NULL;
+	pthread_t threads [CRC_PARALLEL_MAX_THREADS];
+	uint8_t thread_started [CRC_PARALLEL_MAX_THREADS];
+	size_t block_count, range_blocks, block_index, data_offset;
+	crc_value_t crc_register;
+	uint8_t range_count, range_index;
+
+	if (block_len == 0)
+	{
+		block_len = (data_len == 0) ? 1 : data_len;
+	}
+	block_count = (data_len + block_len - 1) / block_len;
+
+	range_count = crc_parallel_thread_count(thread_count, data_len, CRC_PARALLEL_MIN_LEN);
+	if (range_count > block_count)
+	{
+		range_count = (uint8_t)block_count;
+	}
+	if (range_count < 1)
+	{
+		range_count = 1;
+	}
+
+	// look the tables up once here, not in every thread. no shift table if there's no memory for it, it's only faster.
+	(void)crc_model_tables(model);
+	if (block_count >= CRC_BLOCKS_SHIFT_TABLE_MIN)
+	{
+		shift_table = malloc(8 * sizeof(shift_table[0]));
+		if (shift_table != NULL)
+		{
+			fill_crc_shift_table(model, block_len, shift_table);
+		}
+	}
+
+	// whole ranges of range_blocks, which can leave fewer of them.
+	range_blocks = (block_count + range_count - 1) / range_count;
+	if (range_blocks > 0)
+	{
+		range_count = (uint8_t)((block_count + range_blocks - 1) / range_blocks);
+	}
+
+	for (range_index = 0, block_index = 0; range_index < range_count; range_index++, block_index += range_blocks)
+	{
+		data_offset = block_index * block_len;
+		ranges[range_index].model = model;
+		ranges[range_index].byte_data = byte_data + data_offset;
+		ranges[range_index].data_len = (range_index == range_count - 1) ? data_len - data_offset : range_blocks * block_len;
+		ranges[range_index].block_len = block_len;
+		ranges[range_index].block_crcs = block_crcs + block_index;
+		ranges[range_index].shift_table = (const crc_value_t (*) [256])shift_table;
+
+		thread_started[range_index] = (range_index != 0) &&
+				(pthread_create(&threads[range_index], NULL, crc_blocks_range_thread, &ranges[range_index]) == 0);
+	}
+
+	for (range_index = 0; range_index < range_count; range_index++)
+	{
+		if (!thread_started[range_index])
+		{
+			crc_blocks_range_thread(&ranges[range_index]);
+		}
+	}
+
+	crc_register = crc_register_init(model);
+	for (range_index = 0; range_index < range_count; range_index++)
+	{
+		if (thread_started[range_index])
+		{
+			pthread_join(threads[range_index], NULL);
+		}
+
+		crc_register = crc_shift_register(model, crc_register, ranges[range_index].data_len) ^ ranges[range_index].range_register;
+	}
+
+	free(shift_table);
+
+	return crc_register_final(model, crc_register);
+}
+
+// a frame's trailing crc as it goes on the wire: width / 8 bytes, low byte first for a reflected model and high byte first
+// otherwise, the order in which the register takes it back in, see crc_residue().
+void crc_put_trailer(const crc_model_t* model, crc_value_t calculated_crc, uint8_t trailer [])
+{
+	uint8_t byte_index, byte_count = model->width / 8;
+
+	for (byte_index = 0; byte_index < byte_count; byte_index++)
+	{
+		trailer[byte_index] = (uint8_t)(calculated_crc >> (8 * ((model->reflect_input == 1) ? byte_index : byte_count - 1 - byte_index)));
+	}
+}
+
+
+// the raw register every good frame (message || trailer) leaves behind, whatever the message: running the trailer through
+// xors the register down to the final xor value (refin == refout), and that through width zero bits is all that's left.
+// taken from the empty message's frame, which is as good as any.
+crc_value_t crc_residue(crc_model_t* model)
+{
+	uint8_t trailer [8];
+
+	crc_put_trailer(model, crc_register_final(model, crc_register_init(model)), trailer);
+
+	return crc_update_register(model, crc_register_init(model), trailer, model->width / 8);
+}
+
+
+// checks 'count' frames, each a message followed by its crc_put_trailer() trailer, and sets bit (i % 64) of bad_frames[i / 64]
+// for every frame i that fails (bad_frames has (count + 63) / 64 words, all rewritten); returns the number of bad frames.
+// whole frames go through the registers CRC_BATCH_LANES at a time (see crc_calculate_batch()) and each register is compared
+// with the residue, no final xor, reflect or trailer parsing per frame. a frame shorter than a trailer is bad.
+// a model with refin != refout has no residue, its frames are checked the long way.
+size_t crc_verify_frames(crc_model_t* model, const uint8_t* const frame_data [], const size_t frame_len [], size_t count, uint64_t bad_frames [])
+{
+	const crc_tables_t* tables = crc_model_tables(model);
+	crc_value_t init_register = crc_register_init(model), residue = crc_residue(model);
+	crc_value_t lane_registers [CRC_BATCH_LANES];
+	const uint8_t* lane_data [CRC_BATCH_LANES];
+	size_t lane_len [CRC_BATCH_LANES];
+	size_t trailer_len = model->width / 8, frame_index = 0, bad_count = 0;
+	uint8_t trailer [8], lane_index, frame_bad;
+
+	memset(bad_frames, 0, ((count + 63) / 64) * sizeof(bad_frames[0]));
+
+#define CRC_MARK_FRAME(index, bad)		do { bad_frames[(index) / 64] |= (uint64_t)(bad) << ((index) % 64); bad_count += (bad); } while (0)
+
+	if ((model->reflect_input == 1) != (model->reflect_output == 1))
+	{
+		for (; frame_index < count; frame_index++)
+		{
+			frame_bad = 1;
+			if (frame_len[frame_index] >= trailer_len)
+			{
+				crc_put_trailer(model, crc_calculate(model, frame_data[frame_index], frame_len[frame_index] - trailer_len), trailer);
+				frame_bad = (memcmp(trailer, frame_data[frame_index] + frame_len[frame_index] - trailer_len, trailer_len) != 0);
+			}
+			CRC_MARK_FRAME(frame_index, frame_bad);
+		}
+
+		return bad_count;
+	}
+
+	for (; frame_index + CRC_BATCH_LANES <= count; frame_index += CRC_BATCH_LANES)
+	{
+		for (lane_index = 0; lane_index < CRC_BATCH_LANES; lane_index++)
+		{
+			lane_data[lane_index] = frame_data[frame_index + lane_index];
+			lane_len[lane_index] = frame_len[frame_index + lane_index];
+		}
+		crc_update_batch_group(model, tables, init_register, lane_data, lane_len, lane_registers);
+
+		for (lane_index = 0; lane_index < CRC_BATCH_LANES; lane_index++)
+		{
+			CRC_MARK_FRAME(frame_index + lane_index, (lane_registers[lane_index] != residue) | (lane_len[lane_index] < trailer_len));
+		}
+	}
+
+	for (; frame_index < count; frame_index++)
+	{
+		CRC_MARK_FRAME(frame_index, (crc_update_register(model, init_register, frame_data[frame_index], frame_len[frame_index]) != residue) |
+									(frame_len[frame_index] < trailer_len));
+	}
+
+#undef CRC_MARK_FRAME
+
+	return bad_count;
+}
+
+
+
+// the syndrome index registry, same deal as the table registry: entries are never freed, callers keep pointers to them.
+static pthread_mutex_t crc_syndrome_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static crc_syndrome_index_t* crc_syndrome_registry = NULL;
+
+
+static inline uint32_t crc_syndrome_slot(const crc_syndrome_index_t* index, crc_value_t syndrome)
+{
+	return (uint32_t)((syndrome * 0x9E3779B97F4A7C15ULL) >> 32) & index->slot_mask;
+}
+
+
+// the one error position with this syndrome, CRC_SYNDROME_AMBIGUOUS if there's more than one, CRC_SYNDROME_NONE if none.
+static uint32_t crc_syndrome_lookup(const crc_syndrome_index_t* index, crc_value_t syndrome)
+{
+	uint32_t slot = crc_syndrome_slot(index, syndrome);
+
+	while (index->slot_syndromes[slot] != 0)
+	{
+		if (index->slot_syndromes[slot] == syndrome)
+		{
+			return index->slot_positions[slot];
+		}
+		slot = (slot + 1) & index->slot_mask;
+	}
+
+	return CRC_SYNDROME_NONE;
+}
+
+
+static crc_syndrome_index_t* build_crc_syndrome_index(crc_model_t* model, size_t frame_len)
+{
+	crc_syndrome_index_t* index;
+	crc_value_t bit_registers [8];
+	uint32_t position, slot, slot_count = 64;
+	size_t byte_index;
+	uint8_t bit_index, bit_byte;
+	const uint8_t zero_byte = 0;
+
+	index = calloc(1, sizeof(crc_syndrome_index_t));
+	if (index == NULL)
+	{
+		return NULL;
+	}
+
+	index->width = model->width;
+	index->polynomial = model->polynomial & CRC_MASK(model->width);
+	index->reflect_input = (model->reflect_input == 1);
+	index->reflect_output = (model->reflect_output == 1);
+	index->frame_len = frame_len;
+	index->position_count = (uint32_t)(frame_len * 8 + model->width);
+
+	while (slot_count < 2 * index->position_count)
+	{
+		slot_count *= 2;
+	}
+	index->slot_mask = slot_count - 1;
+
+	index->position_syndromes = malloc(index->position_count * sizeof(crc_value_t));
+	index->slot_syndromes = calloc(slot_count, sizeof(crc_value_t));
+	index->slot_positions = malloc(slot_count * sizeof(uint32_t));
+	if (index->position_syndromes == NULL || index->slot_syndromes == NULL || index->slot_positions == NULL)
+	{
+		free(index->position_syndromes);
+		free(index->slot_syndromes);
+		free(index->slot_positions);
+		free(index);
+		return NULL;
+	}
+
+	// the crc is affine in the data, so the syndrome of an error is the crc of the error pattern alone, from a zero
+	// register and without the final xor: init and xorout cancel out. a single bit in the last byte is one step of the
+	// table engine, every byte further from the end is one more zero byte pushed through behind it.
+	for (bit_index = 0; bit_index < 8; bit_index++)
+	{
+		bit_byte = (uint8_t)(1 << bit_index);
+		bit_registers[bit_index] = crc_update_register(model, 0, &bit_byte, 1);
+	}
+	for (byte_index = frame_len; byte_index-- > 0;)
+	{
+		for (bit_index = 0; bit_index < 8; bit_index++)
+		{
+			index->position_syndromes[byte_index * 8 + bit_index] = crc_register_final(model, bit_registers[bit_index]) ^ model->final_xor_value;
+			bit_registers[bit_index] = crc_update_register(model, bit_registers[bit_index], &zero_byte, 1);
+		}
+	}
+
+	// a flipped bit of the received crc is that bit of the syndrome.
+	for (bit_index = 0; bit_index < model->width; bit_index++)
+	{
+		index->position_syndromes[frame_len * 8 + bit_index] = (crc_value_t)1 << bit_index;
+	}
+
+	for (position = 0; position < index->position_count; position++)
+	{
+		slot = crc_syndrome_slot(index, index->position_syndromes[position]);
+		while (index->slot_syndromes[slot] != 0 && index->slot_syndromes[slot] != index->position_syndromes[position])
+		{
+			slot = (slot + 1) & index->slot_mask;
+		}
+
+		if (index->slot_syndromes[slot] != 0)
+		{
+			index->slot_positions[slot] = CRC_SYNDROME_AMBIGUOUS;
+		}
+		else
+		{
+			index->slot_syndromes[slot] = index->position_syndromes[position];
+			index->slot_positions[slot] = position;
+		}
+	}
+
+	return index;
+}
+
+
+// the syndrome index of the model for frames of frame_len bytes, built on first use and shared by every model with the
+// same width, polynomial and directions. thread safe. NULL past CRC_CORRECT_MAX_LEN or if memory ran out.
+const crc_syndrome_index_t* crc_syndrome_index(crc_model_t* model, size_t frame_len)
+{
+	crc_syndrome_index_t* index;
+
+	if (frame_len == 0 || frame_len > CRC_CORRECT_MAX_LEN)
+	{
+		return NULL;
+	}
+
+	pthread_mutex_lock(&crc_syndrome_registry_lock);
+
+	for (index = crc_syndrome_registry; index != NULL; index = index->next)
+	{
+		if (index->width == model->width && index->polynomial == (model->polynomial & CRC_MASK(model->width)) &&
+			index->reflect_input == (model->reflect_input == 1) && index->reflect_output == (model->reflect_output == 1) && index->frame_len == frame_len)
+		{
+			break;
+		}
+	}
+
+	if (index == NULL)
+	{
+		index = build_crc_syndrome_index(model, frame_len);
+		if (index != NULL)
+		{
+			index->next = crc_syndrome_registry;
+			crc_syndrome_registry = index;
+		}
+	}
+
+	pthread_mutex_unlock(&crc_syndrome_registry_lock);
+
+	return index;
+}
+
+
+static void crc_flip_error_position(const crc_syndrome_index_t* index, uint8_t* frame_data, crc_value_t* received_crc, uint32_t position)
+{
+	if (position < index->frame_len * 8)
+	{
+		frame_data[position / 8] ^= (uint8_t)(1 << (position % 8));
+	}
+	else
+	{
+		*received_crc ^= (crc_value_t)1 << (position - index->frame_len * 8);
+	}
+}
+
+
+// checks a frame against the crc that came with it, and if they differ, looks for the one flipped bit (max_bits 1) or
+// up to two (max_bits 2), in the data or in the crc, that explain the difference. if exactly one such error pattern
+// exists it's flipped back in place and its bit count returned. 0: the frame was good. -1: no fix, the frame is left
+// as it was: no pattern of that many bits, more than one (the frame is too long for the model to tell them apart),
+// or frame_len is 0 or past CRC_CORRECT_MAX_LEN.
+// a fix is only as good as the model's hamming distance at that length: correcting t bits is safe with HD >= 2t + 1
+// (CRC-32: HD 5 up to 371 data bytes, so 2 bits there), heavier errors can then still look like a correctable one.
+// a single bit is looked up, two bits cost one lookup per bit position of the frame.
+int crc_correct(crc_model_t* model, uint8_t* frame_data, size_t frame_len, crc_value_t* received_crc, uint8_t max_bits)
+{
+	const crc_syndrome_index_t* index;
+	crc_value_t syndrome = (crc_calculate(model, frame_data, frame_len) ^ *received_crc) & CRC_MASK(model->width);
+	uint32_t position, partner, first_position = 0, second_position = 0;
+	int pairs_found = 0;
+
+	if (syndrome == 0)
+	{
+		return 0;
+	}
+
+	index = crc_syndrome_index(model, frame_len);
+	if (index == NULL || max_bits == 0)
+	{
+		return -1;
+	}
+
+	position = crc_syndrome_lookup(index, syndrome);
+	if (position == CRC_SYNDROME_AMBIGUOUS)
+	{
+		return -1;
+	}
+	if (position != CRC_SYNDROME_NONE)
+	{
+		crc_flip_error_position(index, frame_data, received_crc, position);
+		return 1;
+	}
+	if (max_bits < 2)
+	{
+		return -1;
+	}
+
+	// every position whose syndrome leaves one that another single position has. each pair shows up twice, from both
+	// ends, it counts from the lower one.
+	for (position = 0; position < index->position_count; position++)
+	{
+		partner = crc_syndrome_lookup(index, syndrome ^ index->position_syndromes[position]);
+		if (partner == CRC_SYNDROME_NONE || (partner != CRC_SYNDROME_AMBIGUOUS && partner <= position))
+		{
+			continue;
+		}
+
+		if (partner == CRC_SYNDROME_AMBIGUOUS || crc_syndrome_lookup(index, index->position_syndromes[position]) != position || pairs_found != 0)
+		{
+			return -1;
+		}
+
+		first_position = position;
+		second_position = partner;
+		pairs_found++;
+	}
+
+	if (pairs_found == 0)
+	{
+		return -1;
+	}
+
+	crc_flip_error_position(index, frame_data, received_crc, first_position);
+	crc_flip_error_position(index, frame_data, received_crc, second_position);
+
+	return 2;
+}
+
+
+// window_len bytes of x, then one more byte: take out x[0], put in the new one. one byte table step and two lookups.
+static CRC_FORCE_INLINE crc_value_t crc_rolling_step(const crc_rolling_t* rolling, crc_value_t crc_register, uint8_t out_byte, uint8_t in_byte)
+{
+	if (rolling->reflected)
+	{
+		crc_register = (crc_register >> 8) ^ rolling->in_table[(crc_register ^ in_byte) & 0xFF];
+	}
+	else
+	{
+		crc_register = ((crc_register << 8) & CRC_MASK(rolling->width)) ^ rolling->in_table[((crc_register >> (rolling->width - 8)) ^ in_byte) & 0xFF];
+	}
+
+	return crc_register ^ rolling->out_table[out_byte];
+}
+
+
+// set up a rolling crc over window_len byte windows. -1 for window_len 0. the window itself comes with crc_rolling_start().
+int crc_rolling_init(crc_rolling_t* rolling, crc_model_t* model, size_t window_len)
+{
+	crc_value_t init_register, init_share;
+	uint8_t byte_value;
+	int table_index;
+
+	if (window_len == 0)
+	{
+		return -1;
+	}
+
+	rolling->model = model;
+	rolling->window_len = window_len;
+	rolling->width = model->width;
+	rolling->reflected = (model->reflect_input == 1);
+
+	// the init value is window_len bytes deep at the start of a step and one more after it, the difference goes.
+	init_register = crc_register_init(model);
+	init_share = crc_shift_register(model, init_register, window_len) ^ crc_shift_register(model, init_register, (uint64_t)window_len + 1);
+
+	for (table_index = 0; table_index < 256; table_index++)
+	{
+		byte_value = (uint8_t)table_index;
+		rolling->in_table[table_index] = crc_update_register(model, 0, &byte_value, 1);
+		rolling->out_table[table_index] = crc_shift_register(model, rolling->in_table[table_index], window_len) ^ init_share;
+	}
+
+	rolling->crc_register = init_register;
+
+	return 0;
+}
+
+
+// the first window, window_len bytes of window_data. returns its crc.
+crc_value_t crc_rolling_start(crc_rolling_t* rolling, const uint8_t* window_data)
+{
+	rolling->crc_register = crc_update_register(rolling->model, crc_register_init(rolling->model), window_data, rolling->window_len);
+
+	return crc_register_final(rolling->model, rolling->crc_register);
+}
+
+
+// slide the window one byte: out_byte is the oldest byte of the window, in_byte the one after the newest. returns the
+// crc of the new window, the same as crc_calculate() over it.
+crc_value_t crc_rolling_roll(crc_rolling_t* rolling, uint8_t out_byte, uint8_t in_byte)
+{
+	rolling->crc_register = crc_rolling_step(rolling, rolling->crc_register, out_byte, in_byte);
+
+	return crc_register_final(rolling->model, rolling->crc_register);
+}
+
+
+// every window of byte_data whose crc has (crc & boundary_mask) == boundary_match, as the offset just past the window
+// (a chunk boundary), in order, up to max_positions of them. returns how many went into positions; the scan stops
+// when positions is full. starts over at byte_data[0], so a stream in pieces needs window_len - 1 bytes of overlap;
+// the rolling crc is left on the last window scanned.
+size_t crc_rolling_scan(crc_rolling_t* rolling, const uint8_t* byte_data, size_t data_len, crc_value_t boundary_mask, crc_value_t boundary_match,
+						size_t* positions, size_t max_positions)
+{
+	crc_value_t crc_register, register_match;
+	size_t window_len = rolling->window_len, data_index, position_count = 0;
+
+	if (data_len < window_len || max_positions == 0)
+	{
+		return 0;
+	}
+
+	crc_rolling_start(rolling, byte_data);
+	crc_register = rolling->crc_register;
+
+	if ((crc_register_final(rolling->model, crc_register) & boundary_mask) == boundary_match)
+	{
+		positions[position_count++] = window_len;
+	}
+
+	// with the register already in the output direction, the test goes on the raw register: the final xor moves into
+	// the value to match.
+	if ((rolling->model->reflect_input == 1) == (rolling->model->reflect_output == 1))
+	{
+		register_match = boundary_match ^ (rolling->model->final_xor_value & boundary_mask);
+
+		for (data_index = window_len; data_index < data_len && position_count < max_positions; data_index++)
+		{
+			crc_register = crc_rolling_step(rolling, crc_register, byte_data[data_index - window_len], byte_data[data_index]);
+			if ((crc_register & boundary_mask) == register_match)
+			{
+				positions[position_count++] = data_index + 1;
+			}
+		}
+	}
+	else
+	{
+		for (data_index = window_len; data_index < data_len && position_count < max_positions; data_index++)
+		{
+			crc_register = crc_rolling_step(rolling, crc_register, byte_data[data_index - window_len], byte_data[data_index]);
+			if ((crc_register_final(rolling->model, crc_register) & boundary_mask) == boundary_match)
+			{
+				positions[position_count++] = data_index + 1;
+			}
+		}
+	}
+
+	rolling->crc_register = crc_register;
+
+	return position_count;
+}
+
+
+
+#ifdef USE_ENGINE_TUNING
+static const char* const crc_engine_names [CRC_ENGINES] =
+{
+	"auto", "bitwise", "nibble", "table", "slicing-4", "slicing-8", "slicing-16", "clmul", "hw"
+};
+
+
+// bytes each size class is timed (and cross-checked) at, see CRC_TUNE_BUCKETS.
+static size_t crc_tune_bucket_len(uint8_t bucket)
+{
+	return (size_t)2 << (2 * bucket);
+}
+
+
+// the register the engines start from in the tuner's cross-checks: not 0, so a botched init path shows as well.
+static crc_value_t crc_tune_start_register(const crc_tables_t* tables)
+{
+	return 0xA5C3E1F00F1E3C5AULL & CRC_MASK(tables->width);
+}
+
+
+// ns per call (x 1024, tiny messages take a few ns) of the engine on data_len bytes: batches of doubling size until one
+// takes CRC_TUNE_MIN_NS, best of CRC_TUNE_TRIALS. each call starts from the last one's register, so none can be skipped.
+static uint64_t crc_tune_time_engine(crc_engine_t engine, const crc_tables_t* tables, const uint8_t* byte_data, size_t data_len)
+{
+	volatile crc_value_t crc_sink;
+	crc_value_t crc_register = 0;
+	uint64_t call_count, call_index, start_ns, elapsed_ns, best_time = UINT64_MAX;
+	uint8_t trial_index;
+
+	for (trial_index = 0; trial_index < CRC_TUNE_TRIALS; trial_index++)
+	{
+		for (call_count = 1; ; call_count *= 2)
+		{
+			start_ns = crc_monotonic_ns();
+			for (call_index = 0; call_index < call_count; call_index++)
+			{
+				crc_register = crc_engine_update(engine, tables, crc_register, byte_data, data_len);
+			}
+			elapsed_ns = crc_monotonic_ns() - start_ns;
+
+			if (elapsed_ns >= CRC_TUNE_MIN_NS)
+			{
+				break;
+			}
+		}
+
+		if (elapsed_ns * 1024 / call_count < best_time)
+		{
+			best_time = elapsed_ns * 1024 / call_count;
+		}
+	}
+
+	crc_sink = crc_register;
+	(void)crc_sink;
+
+	return best_time;
+}
+
+
+// does the engine give the bitwise loop's register on data_len bytes.
+static int crc_engine_matches_bitwise(crc_engine_t engine, const crc_tables_t* tables, const uint8_t* byte_data, size_t data_len)
+{
+	crc_value_t start_register = crc_tune_start_register(tables);
+
+	return crc_engine_update(engine, tables, start_register, byte_data, data_len) ==
+			crc_engine_update(CRC_ENGINE_BITWISE, tables, start_register, byte_data, data_len);
+}
+
+
+// tunes one registry entry: for every size class, every usable engine is checked against the bitwise loop and timed, and
+// the fastest that agrees is kept. an engine that disagrees is left out for good and reported on stderr. tune_data holds
+// crc_tune_bucket_len(CRC_TUNE_BUCKETS - 1) bytes. returns -1 if any engine disagreed, the entry is tuned either way.
+static int crc_tune_tables(crc_tables_t* tables, const uint8_t* tune_data)
+{
+	uint8_t engine_broken [CRC_ENGINES] = {0};
+	uint8_t bucket, engine, best_engine;
+	uint64_t engine_time, best_time;
+	size_t data_len;
+	int result = 1;
+
+	for (bucket = 0; bucket < CRC_TUNE_BUCKETS; bucket++)
+	{
+		data_len = crc_tune_bucket_len(bucket);
+		best_engine = CRC_ENGINE_BITWISE;
+		best_time = UINT64_MAX;
+
+		for (engine = CRC_ENGINE_BITWISE; engine < CRC_ENGINES; engine++)
+		{
+			if (engine_broken[engine] || !crc_engine_usable((crc_engine_t)engine, tables))
+			{
+				continue;
+			}
+
+			if (!crc_engine_matches_bitwise((crc_engine_t)engine, tables, tune_data, data_len))
+			{
+				fprintf(stderr, "%u bit 0x%llX %s: %s engine disagrees with the bitwise loop on %u bytes, left out\n", (unsigned)tables->width,
+						(unsigned long long)tables->polynomial, tables->reflected ? "reflected" : "normal", crc_engine_names[engine], (unsigned)data_len);
+				engine_broken[engine] = 1;
+				result = -1;
+				continue;
+			}
+
+			engine_time = crc_tune_time_engine((crc_engine_t)engine, tables, tune_data, data_len);
+			if (engine_time < best_time)
+			{
+				best_time = engine_time;
+				best_engine = engine;
+			}
+		}
+
+		__atomic_store_n(&tables->tuned_engines[bucket], best_engine, __ATOMIC_RELAXED);
+	}
+
+	return result;
+}
+
+
+// random bytes to tune on, the largest size class worth, cache line aligned. free with crc_tune_data_free().
+static uint8_t* crc_tune_data_alloc(void** allocation)
+{
+	size_t data_len = crc_tune_bucket_len(CRC_TUNE_BUCKETS - 1);
+	uint8_t* tune_data;
+
+	*allocation = malloc(data_len + CRC_CACHE_LINE_SIZE - 1);
+	if (*allocation == NULL)
+	{
+		return NULL;
+	}
+	tune_data = (uint8_t*)(((uintptr_t)*allocation + CRC_CACHE_LINE_SIZE - 1) & ~(uintptr_t)(CRC_CACHE_LINE_SIZE - 1));
+
+	fill_crc_test_data(tune_data, data_len, 0x27D4EB2F);
+
+	return tune_data;
+}
+
+
+// tunes the model's registry entry, so every model with the same (width, polynomial, direction). the entry's lock-free
+// readers are fine with it changing under them: every engine it can hold gives the same register.
+int crc_tune_model(crc_model_t* model)
+{
+	crc_tables_t* tables = (crc_tables_t*)crc_model_tables(model);
+	void* allocation;
+	uint8_t* tune_data;
+	int result;
+
+	if (tables == NULL || (tune_data = crc_tune_data_alloc(&allocation)) == NULL)
+	{
+		return -1;
+	}
+
+	result = crc_tune_tables(tables, tune_data);
+	free(allocation);
+
+	return result;
+}
+
+
+// back to the built-in order for every registry entry.
+void crc_tune_clear()
+{
+	crc_tables_t* tables;
+	uint8_t bucket;
+
+	pthread_mutex_lock(&crc_tables_registry_lock);
+	for (tables = crc_tables_registry; tables != NULL; tables = tables->next)
+	{
+		for (bucket = 0; bucket < CRC_TUNE_BUCKETS; bucket++)
+		{
+			__atomic_store_n(&tables->tuned_engines[bucket], CRC_ENGINE_AUTO, __ATOMIC_RELAXED);
+		}
+	}
+	pthread_mutex_unlock(&crc_tables_registry_lock);
+}
+
+
+// what a tuning file was made on: the cpu brand string, blanks as '_'. a file from another cpu is tuned over.
+static void crc_tune_cpu_id(char cpu_id [49])
+{
+	size_t char_index;
+
+	strcpy(cpu_id, "unknown");
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	{
+		unsigned int brand_registers [12];
+		uint8_t leaf_index;
+
+		if (__get_cpuid_max(0x80000000, NULL) >= 0x80000004)
+		{
+			for (leaf_index = 0; leaf_index < 3; leaf_index++)
+			{
+				__get_cpuid(0x80000002 + leaf_index, &brand_registers[4 * leaf_index], &brand_registers[4 * leaf_index + 1],
+							&brand_registers[4 * leaf_index + 2], &brand_registers[4 * leaf_index + 3]);
+			}
+			memcpy(cpu_id, brand_registers, 48);
+			cpu_id[48] = 0;
+		}
+	}
+#endif // __GNUC__ && x86
+
+	for (char_index = 0; cpu_id[char_index] != 0; char_index++)
+	{
+		if (cpu_id[char_index] == ' ' || cpu_id[char_index] == '\t')
+		{
+			cpu_id[char_index] = '_';
+		}
+	}
+}
+
+
+// writes every tuned registry entry:
+//	crickey-tune <version> <size classes> <cpu id>
+//	<width> <polynomial, hex> <reflected> <engine name per size class>...
+int crc_tune_save(FILE* tune_file)
+{
+	const crc_tables_t* tables;
+	char cpu_id [49];
+	uint8_t bucket;
+
+	crc_tune_cpu_id(cpu_id);
+	fprintf(tune_file, "crickey-tune %d %d %s\n", CRC_TUNE_FILE_VERSION, CRC_TUNE_BUCKETS, cpu_id);
+
+	pthread_mutex_lock(&crc_tables_registry_lock);
+	for (tables = crc_tables_registry; tables != NULL; tables = tables->next)
+	{
+		if (__atomic_load_n(&tables->tuned_engines[0], __ATOMIC_RELAXED) == CRC_ENGINE_AUTO)
+		{
+			continue;
+		}
+
+		fprintf(tune_file, "%u %llX %u", (unsigned)tables->width, (unsigned long long)tables->polynomial, (unsigned)tables->reflected);
+		for (bucket = 0; bucket < CRC_TUNE_BUCKETS; bucket++)
+		{
+			fprintf(tune_file, " %s", crc_engine_names[__atomic_load_n(&tables->tuned_engines[bucket], __ATOMIC_RELAXED)]);
+		}
+		fprintf(tune_file, "\n");
+	}
+	pthread_mutex_unlock(&crc_tables_registry_lock);
+
+	return ferror(tune_file) ? -1 : 1;
+}
+
+
+// reads a crc_tune_save() file back. a file for another version, size class count or cpu is refused, and so is one naming an
+// engine this build or cpu can't run, or one that disagrees with the bitwise loop. nothing is applied unless all of it is good.
+int crc_tune_load(FILE* tune_file)
+{
+	crc_tables_t* loaded_tables [64];
+	uint8_t loaded_engines [64][CRC_TUNE_BUCKETS];
+	char line [CRC_TUNE_LINE_MAX], cpu_id [49], file_cpu_id [49], engine_name [16];
+	unsigned int width, reflected, version, bucket_count;
+	unsigned long long polynomial;
+	size_t entry_count = 0, entry_index;
+	uint8_t* tune_data = NULL;
+	void* allocation = NULL;
+	uint8_t bucket, engine;
+	int line_offset, name_len, result = 1;
+
+	crc_tune_cpu_id(cpu_id);
+	if (fgets(line, sizeof(line), tune_file) == NULL ||
+		sscanf(line, "crickey-tune %u %u %48s", &version, &bucket_count, file_cpu_id) != 3 ||
+		version != CRC_TUNE_FILE_VERSION || bucket_count != CRC_TUNE_BUCKETS || strcmp(file_cpu_id, cpu_id) != 0)
+	{
+		return -1;
+	}
+
+	while (result == 1 && fgets(line, sizeof(line), tune_file) != NULL)
+	{
+		if (entry_count == sizeof(loaded_tables) / sizeof(loaded_tables[0]) ||
+			sscanf(line, "%u %llX %u%n", &width, &polynomial, &reflected, &line_offset) != 3 ||
+			(loaded_tables[entry_count] = (crc_tables_t*)crc_tables_lookup((uint8_t)width, polynomial, (uint8_t)reflected)) == NULL)
+		{
+			result = -1;
+			break;
+		}
+
+		for (bucket = 0; bucket < CRC_TUNE_BUCKETS && result == 1; bucket++)
+		{
+			if (sscanf(line + line_offset, " %15s%n", engine_name, &name_len) != 1)
+			{
+				result = -1;
+				break;
+			}
+			line_offset += name_len;
+
+			for (engine = CRC_ENGINE_BITWISE; engine < CRC_ENGINES && strcmp(engine_name, crc_engine_names[engine]) != 0; engine++)
+			{
+			}
+			if (engine == CRC_ENGINES || !crc_engine_usable((crc_engine_t)engine, loaded_tables[entry_count]))
+			{
+				result = -1;
+				break;
+			}
+			loaded_engines[entry_count][bucket] = engine;
+		}
+		entry_count++;
+	}
+
+	// the cross-check the tuner did, on this build: every engine picked, on its size class (capped).
+	if (result == 1 && entry_count > 0 && (tune_data = crc_tune_data_alloc(&allocation)) == NULL)
+	{
+		result = -1;
+	}
+	for (entry_index = 0; entry_index < entry_count && result == 1; entry_index++)
+	{
+		for (bucket = 0; bucket < CRC_TUNE_BUCKETS && result == 1; bucket++)
+		{
+			if (!crc_engine_matches_bitwise((crc_engine_t)loaded_engines[entry_index][bucket], loaded_tables[entry_index], tune_data,
+											(crc_tune_bucket_len(bucket) < CRC_TUNE_CHECK_MAX_LEN) ? crc_tune_bucket_len(bucket) : CRC_TUNE_CHECK_MAX_LEN))
+			{
+				result = -1;
+			}
+		}
+	}
+	free(allocation);
+
+	for (entry_index = 0; entry_index < entry_count && result == 1; entry_index++)
+	{
+		for (bucket = 0; bucket < CRC_TUNE_BUCKETS; bucket++)
+		{
+			__atomic_store_n(&loaded_tables[entry_index]->tuned_engines[bucket], loaded_engines[entry_index][bucket], __ATOMIC_RELAXED);
+		}
+	}
+
+	return result;
+}
+
+
+// the startup step: the tuning in tune_path if it's there and good for this cpu and build, else tunes every catalogue
+// model's registry entry here and now (a few ms each) and writes tune_path for the next process. the file is written
+// under a temporary name and renamed, so processes starting together never read half of one. tune_path NULL: tune, no file.
+// returns -1 if an engine disagreed with the bitwise loop (it's left out) or the file couldn't be written.
+int crc_tune(const char* tune_path)
+{
+	char temp_path [4096];
+	FILE* tune_file;
+	void* allocation;
+	uint8_t* tune_data;
+	size_t model_index;
+	crc_tables_t* tables;
+	int result = 1, load_result, save_result;
+
+	if (tune_path != NULL && (tune_file = fopen(tune_path, "r")) != NULL)
+	{
+		load_result = crc_tune_load(tune_file);
+		fclose(tune_file);
+		if (load_result == 1)
+		{
+			return 1;
+		}
+	}
+
+	if ((tune_data = crc_tune_data_alloc(&allocation)) == NULL)
+	{
+		return -1;
+	}
+
+	crc_tune_clear();
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		tables = (crc_tables_t*)crc_model_tables(&crc_catalogue[model_index]);
+		if (tables != NULL && __atomic_load_n(&tables->tuned_engines[0], __ATOMIC_RELAXED) == CRC_ENGINE_AUTO &&
+			crc_tune_tables(tables, tune_data) != 1)
+		{
+			result = -1;
+		}
+	}
+	free(allocation);
+
+	if (tune_path != NULL)
+	{
+		snprintf(temp_path, sizeof(temp_path), "%s.%ld.tmp", tune_path, (long)getpid());
+		tune_file = fopen(temp_path, "w");
+		if (tune_file == NULL)
+		{
+			return -1;
+		}
+
+		save_result = crc_tune_save(tune_file);
+		if (fclose(tune_file) != 0 || save_result != 1 || rename(temp_path, tune_path) != 0)
+		{
+			remove(temp_path);
+			result = -1;
+		}
+	}
+
+	return result;
+}
+#endif // USE_ENGINE_TUNING
+
+
+#define CRC_CHECK_THREADS		(4)
+
+typedef struct
+{
+	crc_model_t models [CRC_CATALOGUE_SIZE];
+	size_t first_model;
+	const uint8_t* byte_data;
+	size_t data_len;
+	crc_value_t results [CRC_CATALOGUE_SIZE];
+} check_crc_models_thread_t;
+
+
+// every thread runs its own copy of the catalogue (tables not looked up yet), starting at a different model,
+// so the threads race on building and publishing the registry entries.
+static void* check_crc_models_thread(void* thread_argument)
+{
+	check_crc_models_thread_t* thread_state = thread_argument;
+	size_t model_index, rotated_index;
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		rotated_index = (model_index + thread_state->first_model) % CRC_CATALOGUE_SIZE;
+		thread_state->results[rotated_index] = crc_calculate(&thread_state->models[rotated_index], thread_state->byte_data, thread_state->data_len);
+	}
+
+	return NULL;
+}
+
+
+int check_crc_models()
+{
+	static const size_t data_lengths [] = {0, 1, 15, 16, 17, 63, 64, 65, 200, 1000, 4096};
+	static uint8_t data_array [4096 + 16];
+	static check_crc_models_thread_t thread_states [CRC_CHECK_THREADS];
+	pthread_t threads [CRC_CHECK_THREADS];
+	size_t model_index, length_index, thread_index;
+	crc_model_t* model;
+
+	fill_crc_test_data(data_array, sizeof(data_array), 0x2545F491);
+
+	// several threads computing every model at the same time, on fresh models, against the bitwise reference.
+	for (thread_index = 0; thread_index < CRC_CHECK_THREADS; thread_index++)
+	{
+		memcpy(thread_states[thread_index].models, crc_catalogue, sizeof(crc_catalogue));
+		thread_states[thread_index].first_model = thread_index * CRC_CATALOGUE_SIZE / CRC_CHECK_THREADS;
+		thread_states[thread_index].byte_data = data_array + 3;
+		thread_states[thread_index].data_len = 4096 - 3;
+
+		if (pthread_create(&threads[thread_index], NULL, check_crc_models_thread, &thread_states[thread_index]) != 0)
+		{
+			printf("could not start check thread\n");
+			return -1;
+		}
+	}
+
+	for (thread_index = 0; thread_index < CRC_CHECK_THREADS; thread_index++)
+	{
+		pthread_join(threads[thread_index], NULL);
+	}
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+
+		for (thread_index = 0; thread_index < CRC_CHECK_THREADS; thread_index++)
+		{
+			if (thread_states[thread_index].results[model_index] != crc_calculate_bitwise(model, data_array + 3, 4096 - 3) ||
+				crc_model_tables(&thread_states[thread_index].models[model_index]) != crc_model_tables(model))
+			{
+				printf("%s: concurrent check failed!\n", model->name);
+				return -1;
+			}
+		}
+	}
+
+	// catalogue check values, and every engine threshold against the bitwise reference.
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+
+		if (crc_calculate(model, (const uint8_t*)"123456789", 9) != model->check)
+		{
+			printf("%s reference check failed!\n", model->name);
+			return -1;
+		}
+
+		for (length_index = 0; length_index < sizeof(data_lengths) / sizeof(data_lengths[0]); length_index++)
+		{
+			if (crc_calculate(model, data_array + 5, data_lengths[length_index]) != crc_calculate_bitwise(model, data_array + 5, data_lengths[length_index]))
+			{
+				printf("%s engine mismatch, len %u\n", model->name, (unsigned)data_lengths[length_index]);
+				return -1;
+			}
+		}
+	}
+
+	// models with the same (width, polynomial, direction) share one set of tables, the other direction gets its own.
+	if (crc_model_tables(crc_find_model("CRC-32")) != crc_model_tables(crc_find_model("CRC-32/JAMCRC")) ||
+		crc_model_tables(crc_find_model("CRC-32/BZIP2")) != crc_model_tables(crc_find_model("CRC-32/MPEG-2")) ||
+		crc_model_tables(crc_find_model("CRC-32/BZIP2")) != crc_model_tables(crc_find_model("CRC-32/POSIX")) ||
+		crc_model_tables(crc_find_model("CRC-32")) == crc_model_tables(crc_find_model("CRC-32/BZIP2")))
+	{
+		printf("table registry sharing check failed!\n");
+		return -1;
+	}
+
+	return 1; // ok.
+}
+
+
+#ifdef USE_NIBBLE_TABLES
+// the nibble engine on every model it's built for against the bitwise loop, from the model's start register and from a
+// random one, and the legacy generate_crc*_nibble_table() globals against the registry's tables.
+int check_crc_nibble()
+{
+	static uint8_t data_array [1024 + 8];
+	const crc_tables_t* tables;
+	const void* legacy_table;
+	uint32_t random_state = 0x1B873593;
+	size_t model_index, data_len;
+	crc_value_t start_register;
+	crc_model_t* model;
+
+	random_state = fill_crc_test_data(data_array, sizeof(data_array), random_state);
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+		tables = crc_model_tables(model);
+
+		if (!crc_engine_usable(CRC_ENGINE_NIBBLE, tables))
+		{
+			continue;
+		}
+
+		for (data_len = 0; data_len <= 1024; data_len = (data_len < 70) ? data_len + 1 : data_len * 2)
+		{
+			crc_test_random(&random_state);
+			start_register = (data_len & 1) ? crc_register_init(model) : ((crc_value_t)random_state << 32 | (random_state * 7)) & CRC_MASK(model->width);
+
+			if (crc_engine_update(CRC_ENGINE_NIBBLE, tables, start_register, data_array + 3, data_len) !=
+				crc_engine_update(CRC_ENGINE_BITWISE, tables, start_register, data_array + 3, data_len))
+			{
+				printf("%s nibble engine mismatch, len %u\n", model->name, (unsigned)data_len);
+				return -1;
+			}
+		}
+
+		legacy_table = NULL;
+		switch (model->width)
+		{
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_8
+			case CRC_WIDTH_8:
+				generate_crc8_nibble_table((uint8_t)model->polynomial);
+				legacy_table = tables->reflected ? crc8_nibble_table_reflected : crc8_nibble_table;
+				break;
+#endif // USE_NIBBLE_TABLE_FOR_CRC_8
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_16
+			case CRC_WIDTH_16:
+				generate_crc16_nibble_table((uint16_t)model->polynomial);
+				legacy_table = tables->reflected ? crc16_nibble_table_reflected : crc16_nibble_table;
+				break;
+#endif // USE_NIBBLE_TABLE_FOR_CRC_16
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+			case CRC_WIDTH_32:
+				generate_crc32_nibble_table((uint32_t)model->polynomial);
+				legacy_table = tables->reflected ? crc32_nibble_table_reflected : crc32_nibble_table;
+				break;
+#endif // USE_NIBBLE_TABLE_FOR_CRC_32
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_64
+			case CRC_WIDTH_64:
+				generate_crc64_nibble_table(model->polynomial);
+				legacy_table = tables->reflected ? crc64_nibble_table_reflected : crc64_nibble_table;
+				break;
+#endif // USE_NIBBLE_TABLE_FOR_CRC_64
+			default:
+				break;
+		}
+
+		if (legacy_table == NULL || memcmp(legacy_table, &tables->nibble, 16 * (model->width / 8)) != 0)
+		{
+			printf("%s nibble table check failed!\n", model->name);
+			return -1;
+		}
+	}
+
+	return 1; // ok.
+}
+#endif // USE_NIBBLE_TABLES
+
+
+// every catalogue model fed in uneven chunks (empty ones, single bytes, chunks straddling the engine thresholds)
+// against the one-shot crc_calculate(), including a crc_final() halfway through.
+int check_crc_streaming()
+{
+	static const size_t chunk_lengths [] = {0, 1, 7, 64, 3, 0, 200, 15, 16, 1000, 65, 2};
+	static uint8_t data_array [4096];
+	size_t model_index, chunk_index, data_offset;
+	crc_model_t* model;
+	crc_context_t context;
+
+	fill_crc_test_data(data_array, sizeof(data_array), 0x6C078965);
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+
+		crc_init(&context, model);
+		if (crc_final(&context) != crc_calculate(model, data_array, 0))
+		{
+			printf("%s streaming check failed, empty message\n", model->name);
+			return -1;
+		}
+
+		data_offset = 0;
+		for (chunk_index = 0; data_offset < sizeof(data_array); chunk_index = (chunk_index + 1) % (sizeof(chunk_lengths) / sizeof(chunk_lengths[0])))
+		{
+			size_t chunk_len = chunk_lengths[chunk_index];
+			if (chunk_len > sizeof(data_array) - data_offset)
+			{
+				chunk_len = sizeof(data_array) - data_offset;
+			}
+
+			crc_update(&context, data_array + data_offset, chunk_len);
+			data_offset += chunk_len;
+
+			if (context.data_len != data_offset || crc_final(&context) != crc_calculate(model, data_array, data_offset))
+			{
+				printf("%s streaming check failed, after %u bytes\n", model->name, (unsigned)data_offset);
+				return -1;
+			}
+		}
+	}
+
+	return 1; // ok.
+}
+
+
+// every catalogue model over random scatter-gather lists of the same buffer: empty, tiny and long segments in any order,
+// against crc_calculate() over the flat buffer, and crc_update_iov() carrying on from a context already in use.
+int check_crc_iov()
+{
+	static uint8_t data_array [4096];
+	crc_segment_t segments [256];
+#ifdef USE_MMAP_FOR_CLI
+	struct iovec io_segments [2];
+#endif // USE_MMAP_FOR_CLI
+	uint32_t random_state = 0xE6546B64;
+	size_t model_index, data_offset, segment_len;
+	int segment_count, trial_index;
+	crc_model_t* model;
+	crc_context_t context;
+
+	random_state = fill_crc_test_data(data_array, sizeof(data_array), random_state);
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+
+		if (crc_iov(model, segments, 0) != crc_calculate(model, data_array, 0))
+		{
+			printf("%s iov check failed, no segments\n", model->name);
+			return -1;
+		}
+
+		for (trial_index = 0; trial_index < 8; trial_index++)
+		{
+			// mostly tiny segments, with a few past the staging buffer.
+			data_offset = 0;
+			for (segment_count = 0; segment_count < 256 && data_offset < sizeof(data_array); segment_count++)
+			{
+				crc_test_random(&random_state);
+				segment_len = ((random_state >> 16) % 8 == 0) ? (random_state >> 8) % 700 : (random_state >> 8) % 20;
+				if (segment_len > sizeof(data_array) - data_offset)
+				{
+					segment_len = sizeof(data_array) - data_offset;
+				}
+				segments[segment_count].base = data_array + data_offset;
+				segments[segment_count].len = segment_len;
+				data_offset += segment_len;
+			}
+
+			if (crc_iov(model, segments, segment_count) != crc_calculate(model, data_array, data_offset))
+			{
+				printf("%s iov check failed, %d segments, %zu bytes\n", model->name, segment_count, data_offset);
+				return -1;
+			}
+
+			crc_init(&context, model);
+			crc_update(&context, data_array, segments[0].len);
+			crc_update_iov(&context, segments + 1, segment_count - 1);
+			if (crc_final(&context) != crc_calculate(model, data_array, data_offset) || context.data_len != data_offset)
+			{
+				printf("%s iov check failed, after a crc_update()\n", model->name);
+				return -1;
+			}
+		}
+	}
+
+#ifdef USE_MMAP_FOR_CLI
+	// an iovec array goes in cast.
+	io_segments[0].iov_base = data_array;
+	io_segments[0].iov_len = 100;
+	io_segments[1].iov_base = data_array + 100;
+	io_segments[1].iov_len = 900;
+	if (sizeof(crc_segment_t) != sizeof(struct iovec) || offsetof(crc_segment_t, len) != offsetof(struct iovec, iov_len) ||
+		crc_iov(&crc_catalogue[0], (const crc_segment_t*)io_segments, 2) != crc_calculate(&crc_catalogue[0], data_array, 1000))
+	{
+		printf("iov check failed, struct iovec\n");
+		return -1;
+	}
+#endif // USE_MMAP_FOR_CLI
+
+	return 1; // ok.
+}
+
+
+// crc_copy_engine() with every engine on every catalogue model (the ones that can't run a model fall back), lengths
+// around the copy block from unaligned ends, and one copy past CRC_COPY_STREAM_LEN: the crc against crc_calculate()
+// and the copy byte for byte, with the bytes just past it left alone.
+int check_crc_copy()
+{
+	static const size_t data_lengths [] = {0, 1, 15, 16, 17, 100, 4095, 4096, 4097, 10000};
+	static uint8_t source_array [10000 + 16], destination_array [10000 + 16];
+	uint32_t random_state = 0x61C88647;
+	size_t model_index, length_index, data_len;
+	uint8_t* source_buffer;
+	uint8_t* destination_buffer;
+	crc_model_t* model;
+	int engine;
+
+	random_state = fill_crc_test_data(source_array, sizeof(source_array), random_state);
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+
+		for (engine = CRC_ENGINE_AUTO; engine < CRC_ENGINES; engine++)
+		{
+			for (length_index = 0; length_index < sizeof(data_lengths) / sizeof(data_lengths[0]); length_index++)
+			{
+				data_len = data_lengths[length_index];
+				memset(destination_array, 0xA5, sizeof(destination_array));
+
+				if (crc_copy_engine(model, (crc_engine_t)engine, destination_array + 5, source_array + 3, data_len) != crc_calculate(model, source_array + 3, data_len) ||
+					memcmp(destination_array + 5, source_array + 3, data_len) != 0 || destination_array[4] != 0xA5 || destination_array[5 + data_len] != 0xA5)
+				{
+					printf("%s copy check failed, engine %d, %zu bytes\n", model->name, engine, data_len);
+					return -1;
+				}
+			}
+		}
+	}
+
+	data_len = CRC_COPY_STREAM_LEN + 4099;
+	source_buffer = malloc(data_len + 16);
+	destination_buffer = malloc(data_len + 16);
+	if (source_buffer == NULL || destination_buffer == NULL)
+	{
+		free(source_buffer);
+		free(destination_buffer);
+		printf("copy check failed, out of memory\n");
+		return -1;
+	}
+
+	random_state = fill_crc_test_data(source_buffer, data_len + 16, random_state);
+	memset(destination_buffer, 0xA5, data_len + 16);
+
+	model = crc_find_model("CRC-32");
+	if (crc_copy(model, destination_buffer + 7, source_buffer + 1, data_len) != crc_calculate(model, source_buffer + 1, data_len) ||
+		memcmp(destination_buffer + 7, source_buffer + 1, data_len) != 0 || destination_buffer[6] != 0xA5 || destination_buffer[7 + data_len] != 0xA5)
+	{
+		free(source_buffer);
+		free(destination_buffer);
+		printf("copy check failed, %zu bytes\n", data_len);
+		return -1;
+	}
+
+	free(source_buffer);
+	free(destination_buffer);
+
+	return 1; // ok.
+}
+
+
+// crc_combine() against crc_calculate() at every kind of split point, crc_extend_zeros() against real zero bytes,
+// and huge zero runs through the additive property: extend(extend(crc, a), b) == extend(crc, a + b).
+int check_crc_combine()
+{
+	static const size_t split_points [] = {0, 1, 5, 16, 64, 100, 1000, 2047, 2048};
+	static uint8_t data_array [2048 + 4096];
+	size_t model_index, split_index;
+	crc_model_t* model;
+	crc_value_t crc_a, crc_b, crc_whole;
+
+	fill_crc_test_data(data_array, 2048, 0x41C64E6D);
+	memset(data_array + 2048, 0, 4096);
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+		crc_whole = crc_calculate(model, data_array, 2048);
+
+		for (split_index = 0; split_index < sizeof(split_points) / sizeof(split_points[0]); split_index++)
+		{
+			crc_a = crc_calculate(model, data_array, split_points[split_index]);
+			crc_b = crc_calculate(model, data_array + split_points[split_index], 2048 - split_points[split_index]);
+
+			if (crc_combine(model, crc_a, crc_b, 2048 - split_points[split_index]) != crc_whole)
+			{
+				printf("%s combine check failed, split at %u\n", model->name, (unsigned)split_points[split_index]);
+				return -1;
+			}
+
+			if (crc_extend_zeros(model, crc_whole, 4096 - split_points[split_index]) != crc_calculate(model, data_array, 2048 + 4096 - split_points[split_index]))
+			{
+				printf("%s zero extension check failed, %u zeros\n", model->name, (unsigned)(4096 - split_points[split_index]));
+				return -1;
+			}
+		}
+
+		if (crc_extend_zeros(model, crc_extend_zeros(model, crc_whole, 0x123456789ULL), 0xFEDCBA987ULL) != crc_extend_zeros(model, crc_whole, 0x123456789ULL + 0xFEDCBA987ULL))
+		{
+			printf("%s long zero extension check failed\n", model->name);
+			return -1;
+		}
+	}
+
+	return 1; // ok.
+}
+
+// crc_patch() against recalculating the patched buffer, for every model: patches at the start, the middle and the very end,
+// from empty to longer than its delta chunk, and a patch that doesn't fit.
+int check_crc_patch()
+{
+	static const size_t patch_offsets [] = {0, 1, 7, 1000, 4000, 4095, 4096};
+	static const size_t patch_lens [] = {0, 1, 4, 37, 300};
+	static uint8_t data_array [4096], patched_array [4096], new_bytes [300];
+	uint32_t random_state = 0x846CA68B;
+	size_t model_index, offset_index, len_index, patch_len;
+	crc_model_t* model;
+	crc_value_t old_crc;
+
+	random_state = fill_crc_test_data(data_array, sizeof(data_array), random_state);
+	random_state = fill_crc_test_data(new_bytes, sizeof(new_bytes), random_state);
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+		old_crc = crc_calculate(model, data_array, sizeof(data_array));
+
+		for (offset_index = 0; offset_index < sizeof(patch_offsets) / sizeof(patch_offsets[0]); offset_index++)
+		{
+			for (len_index = 0; len_index < sizeof(patch_lens) / sizeof(patch_lens[0]); len_index++)
+			{
+				patch_len = patch_lens[len_index];
+				if (patch_offsets[offset_index] + patch_len > sizeof(data_array))
+				{
+					patch_len = sizeof(data_array) - patch_offsets[offset_index];
+				}
+
+				memcpy(patched_array, data_array, sizeof(data_array));
+				memcpy(patched_array + patch_offsets[offset_index], new_bytes, patch_len);
+
+				if (crc_patch(model, old_crc, sizeof(data_array), patch_offsets[offset_index], data_array + patch_offsets[offset_index], new_bytes, patch_len) !=
+					crc_calculate(model, patched_array, sizeof(patched_array)))
+				{
+					printf("%s patch check failed, %u bytes at %u\n", model->name, (unsigned)patch_len, (unsigned)patch_offsets[offset_index]);
+					return -1;
+				}
+			}
+		}
+
+		if (crc_patch(model, old_crc, sizeof(data_array), 4000, data_array + 4000, new_bytes, 97) != old_crc)
+		{
+			printf("%s patch check failed, patch past the end\n", model->name);
+			return -1;
+		}
+	}
+
+	return 1; // ok.
+}
+
+
+// crc_calculate_parallel() with all sorts of thread counts, with min_len forcing short and uneven chunks, against the
+// single threaded crc_calculate(), and for the 32 bit models against the legacy calculate_crc32() as well.
+int check_crc_parallel()
+{
+	static const uint8_t thread_counts [] = {0, 1, 2, 3, 5, 8, CRC_PARALLEL_MAX_THREADS};
+	static const size_t min_lens [] = {1, 64, 1000, 40000};
+	static uint8_t data_array [100000 + 3];
+	size_t model_index, thread_index, min_len_index;
+	crc_model_t* model;
+	crc_value_t expected_crc;
+
+	fill_crc_test_data(data_array, sizeof(data_array), 0x5851F42D);
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+		expected_crc = crc_calculate(model, data_array + 3, sizeof(data_array) - 3);
+
+		// calculate_crc32() runs on the global tables, set up for this polynomial first.
+#ifdef USE_TABLE_FOR_CRC_32
+		if (model->width == CRC_WIDTH_32)
+		{
+			generate_crc32_table(model->polynomial);
+		}
+#endif // USE_TABLE_FOR_CRC_32
+#ifdef USE_NIBBLE_TABLE_FOR_CRC_32
+		if (model->width == CRC_WIDTH_32)
+		{
+			generate_crc32_nibble_table(model->polynomial);
+		}
+#endif // USE_NIBBLE_TABLE_FOR_CRC_32
+		if (model->width == CRC_WIDTH_32 &&
+			expected_crc != calculate_crc32(data_array + 3, sizeof(data_array) - 3, model->initial_value, model->final_xor_value, model->polynomial, model->reflect_input, model->reflect_output))
+		{
+			printf("%s: crc_calculate() and calculate_crc32() disagree\n", model->name);
+			return -1;
+		}
+
+		for (thread_index = 0; thread_index < sizeof(thread_counts) / sizeof(thread_counts[0]); thread_index++)
+		{
+			for (min_len_index = 0; min_len_index < sizeof(min_lens) / sizeof(min_lens[0]); min_len_index++)
+			{
+				if (crc_calculate_parallel(model, data_array + 3, sizeof(data_array) - 3, thread_counts[thread_index], min_lens[min_len_index]) != expected_crc)
+				{
+					printf("%s parallel check failed, %u threads, min len %u\n", model->name, thread_counts[thread_index], (unsigned)min_lens[min_len_index]);
+					return -1;
+				}
+			}
+		}
+
+		// below the threshold, the default threshold, and fewer aligned pieces than threads.
+		if (crc_calculate_parallel(model, data_array, 100, 4, 0) != crc_calculate(model, data_array, 100) ||
+			crc_calculate_parallel(model, data_array, 0, 4, 1) != crc_calculate(model, data_array, 0) ||
+			crc_calculate_parallel(model, data_array, 1000, CRC_PARALLEL_MAX_THREADS, 1) != crc_calculate(model, data_array, 1000))
+		{
+			printf("%s parallel check failed, short buffer\n", model->name);
+			return -1;
+		}
+	}
+
+	return 1; // ok.
+}
+
+
+#if defined(USE_CONST_TABLES) && !defined(CRICKEY_GENERATE_TABLES)
+// the tables in crickey_tables.h against freshly built ones, a stale header (other polynomial, other slicing code) shows up here.
+int check_crc_const_tables()
+{
+	static uint8_t table_memory [CRC_SLICES_MAX * 256 * 8];
+	const crc_const_tables_t* const_tables;
+	const crc_tables_t* registry_tables;
+	size_t entry_index;
+
+	for (entry_index = 0; entry_index < sizeof(crc_const_tables) / sizeof(crc_const_tables[0]); entry_index++)
+	{
+		const_tables = &crc_const_tables[entry_index];
+		if (const_tables->table_memory == NULL)
+		{
+			continue;
+		}
+
+		fill_crc_tables(table_memory, const_tables->width, const_tables->polynomial, const_tables->reflected, const_tables->slices);
+
+		if (memcmp(table_memory, const_tables->table_memory, (size_t)const_tables->slices * 256 * (const_tables->width / 8)) != 0)
+		{
+			printf("const table %d bit, poly 0x%llX check failed, regenerate crickey_tables.h\n", const_tables->width, (unsigned long long)const_tables->polynomial);
+			return -1;
+		}
+
+		// and the registry hands them out instead of building its own, if the slice count fits this build.
+		registry_tables = crc_tables_lookup(const_tables->width, const_tables->polynomial, const_tables->reflected);
+		if (registry_tables->slices == const_tables->slices && registry_tables->slicing.memory != const_tables->table_memory)
+		{
+			printf("const table %d bit, poly 0x%llX not used by the registry\n", const_tables->width, (unsigned long long)const_tables->polynomial);
+			return -1;
+		}
+	}
+
+	return 1; // ok.
+}
+#endif // USE_CONST_TABLES
+
+
+// crc_calculate_batch() and crc_calculate_packed() against crc_calculate() for every model, with message counts that don't
+// fill the last group, lengths from 0 to past CRC_CLMUL_MIN_LEN (so some groups go per message) and unaligned starts.
+int check_crc_batch()
+{
+	static const size_t message_counts [] = {0, 1, 3, 4, 5, 37};
+	static uint8_t data_array [37 * 700];
+	static const uint8_t* message_data [37];
+	static size_t message_len [37], offsets [37 + 1];
+	static crc_value_t batch_crcs [37], packed_crcs [37];
+	uint32_t random_state = 0x2F6B7A91;
+	size_t model_index, count_index, message_index;
+	crc_model_t* model;
+
+	random_state = fill_crc_test_data(data_array, sizeof(data_array), random_state);
+
+	offsets[0] = 0;
+	for (message_index = 0; message_index < 37; message_index++)
+	{
+		message_len[message_index] = (crc_test_random(&random_state) >> 16) % ((message_index < 20) ? 300 : 690);
+		message_data[message_index] = data_array + offsets[message_index] + (message_index % 7);
+		offsets[message_index + 1] = offsets[message_index] + message_len[message_index];
+	}
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+
+		for (count_index = 0; count_index < sizeof(message_counts) / sizeof(message_counts[0]); count_index++)
+		{
+			crc_calculate_batch(model, message_data, message_len, message_counts[count_index], batch_crcs);
+			crc_calculate_packed(model, data_array, offsets, message_counts[count_index], packed_crcs);
+
+			for (message_index = 0; message_index < message_counts[count_index]; message_index++)
+			{
+				if (batch_crcs[message_index] != crc_calculate(model, message_data[message_index], message_len[message_index]) ||
+					packed_crcs[message_index] != crc_calculate(model, data_array + offsets[message_index], message_len[message_index]))
+				{
+					printf("%s batch check failed, message %u of %u\n", model->name, (unsigned)message_index, (unsigned)message_counts[count_index]);
+					return -1;
+				}
+			}
+		}
+	}
+
+	return 1; // ok.
+}
+
+
+// crc_calculate_blocks() on every catalogue model, block lengths that do and don't divide the buffer, against
+// crc_calculate() per block and over the whole buffer, and past CRC_PARALLEL_MIN_LEN per range on 5 threads.
+int check_crc_blocks()
+{
+	static const size_t block_lengths [] = {0, 1, 7, 64, 512, 1000, 5000};
+	static uint8_t data_array [5000];
+	static crc_value_t block_crcs [5000];
+	uint32_t random_state = 0x9E485565;
+	size_t model_index, length_index, block_len, block_index, block_count, data_len;
+	crc_value_t* big_block_crcs;
+	uint8_t* data_buffer;
+	crc_model_t* model;
+	int result = 1;
+
+	random_state = fill_crc_test_data(data_array, sizeof(data_array), random_state);
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+
+		for (length_index = 0; length_index < sizeof(block_lengths) / sizeof(block_lengths[0]); length_index++)
+		{
+			block_len = block_lengths[length_index];
+			data_len = sizeof(data_array) - length_index;
+			block_count = (block_len == 0) ? 1 : (data_len + block_len - 1) / block_len;
+
+			if (crc_calculate_blocks(model, data_array, data_len, block_len, block_crcs, 0) != crc_calculate(model, data_array, data_len))
+			{
+				printf("%s blocks check failed, object crc, blocks of %zu\n", model->name, block_len);
+				return -1;
+			}
+			for (block_index = 0; block_index < block_count; block_index++)
+			{
+				if (block_crcs[block_index] != crc_calculate(model, data_array + block_index * block_len,
+						(block_index == block_count - 1) ? data_len - block_index * block_len : block_len))
+				{
+					printf("%s blocks check failed, block %zu of %zu bytes\n", model->name, block_index, block_len);
+					return -1;
+				}
+			}
+		}
+
+		if (crc_calculate_blocks(model, data_array, 0, 64, block_crcs, 0) != crc_calculate(model, data_array, 0))
+		{
+			printf("%s blocks check failed, empty buffer\n", model->name);
+			return -1;
+		}
+	}
+
+	data_len = 5 * CRC_PARALLEL_MIN_LEN + 3000;
+	block_len = 4096;
+	block_count = (data_len + block_len - 1) / block_len;
+	data_buffer = malloc(data_len);
+	big_block_crcs = malloc(block_count * sizeof(crc_value_t));
+	if (data_buffer == NULL || big_block_crcs == NULL)
+	{
+		free(data_buffer);
+		free(big_block_crcs);
+		printf("blocks check failed, out of memory\n");
+		return -1;
+	}
+
+	random_state = fill_crc_test_data(data_buffer, data_len, random_state);
+
+	model = crc_find_model("CRC-64/XZ");
+	if (crc_calculate_blocks(model, data_buffer, data_len, block_len, big_block_crcs, 5) != crc_calculate(model, data_buffer, data_len))
+	{
+		printf("blocks check failed, object crc on threads\n");
+		result = -1;
+	}
+	for (block_index = 0; block_index < block_count && result == 1; block_index++)
+	{
+		if (big_block_crcs[block_index] != crc_calculate(model, data_buffer + block_index * block_len,
+				(block_index == block_count - 1) ? data_len - block_index * block_len : block_len))
+		{
+			printf("blocks check failed, block %zu on threads\n", block_index);
+			result = -1;
+		}
+	}
+
+	free(data_buffer);
+	free(big_block_crcs);
+
+	return result;
+}
+
+// crc_verify_frames() for every model over 70 frames (more than one bitmap word, not a whole number of lane groups): good frames,
+// frames with one bit flipped in the message or in the trailer, and frames too short for a trailer. crc_residue() against the
+// residue the reveng catalogue lists for CRC-32 and CRC-32C as well.
+int check_crc_verify_frames()
+{
+	static uint8_t frame_array [70][300 + 8];
+	static const uint8_t* frame_data [70];
+	static size_t frame_len [70];
+	uint64_t bad_frames [2], expected_bad [2];
+	uint32_t random_state = 0xCC9E2D51;
+	size_t model_index, frame_index, expected_count, message_len;
+	crc_model_t* model;
+
+	if (crc_residue(crc_find_model("CRC-32")) != 0xDEBB20E3 || crc_residue(crc_find_model("CRC-32C")) != 0xB798B438)
+	{
+		printf("residue check failed, CRC-32 0x%llX, CRC-32C 0x%llX\n", (unsigned long long)crc_residue(crc_find_model("CRC-32")),
+				(unsigned long long)crc_residue(crc_find_model("CRC-32C")));
+		return -1;
+	}
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+		expected_bad[0] = expected_bad[1] = 0;
+		expected_count = 0;
+
+		for (frame_index = 0; frame_index < 70; frame_index++)
+		{
+			message_len = (crc_test_random(&random_state) >> 16) % 300;
+			random_state = fill_crc_test_data(frame_array[frame_index], message_len, random_state);
+			crc_put_trailer(model, crc_calculate(model, frame_array[frame_index], message_len), frame_array[frame_index] + message_len);
+			frame_data[frame_index] = frame_array[frame_index];
+			frame_len[frame_index] = message_len + model->width / 8;
+
+			switch (frame_index % 5)
+			{
+				case 1:		// a bit of the frame, message or trailer.
+					frame_array[frame_index][(random_state >> 8) % frame_len[frame_index]] ^= (uint8_t)(1 << (random_state % 8));
+					break;
+				case 3:		// shorter than a trailer.
+					frame_len[frame_index] = (model->width / 8) - 1;
+					break;
+				default:
+					continue;
+			}
+			expected_bad[frame_index / 64] |= (uint64_t)1 << (frame_index % 64);
+			expected_count++;
+		}
+
+		if (crc_verify_frames(model, frame_data, frame_len, 70, bad_frames) != expected_count ||
+			bad_frames[0] != expected_bad[0] || bad_frames[1] != expected_bad[1])
+		{
+			printf("%s frame verification check failed\n", model->name);
+			return -1;
+		}
+	}
+
+	return 1; // ok.
+}
+
+// single and double bit errors anywhere in the frame or its crc, corrected back to the original on CRC-32 (HD 6 at 64 bytes).
+// CRC-16/CCITT-FALSE (HD 4) must fix every single bit and never make a wrong double bit fix, and CRC-8 over a frame far
+// past its 255 syndromes must never fix anything wrong (and can miss an error altogether).
+int check_crc_correct()
+{
+	static const char* const model_names [] = {"CRC-32", "CRC-16/CCITT-FALSE", "CRC-8", "CRC-64/XZ"};
+	static const size_t frame_lens [] = {64, 32, 200, 100};
+	uint8_t frame_data [256], original_data [256];
+	crc_value_t received_crc, original_crc;
+	uint32_t random_state = 0x3243F6A8, position_count, first_position, second_position;
+	size_t model_index, trial_index, frame_len;
+	crc_model_t* model;
+	int result;
+
+	for (model_index = 0; model_index < sizeof(model_names) / sizeof(model_names[0]); model_index++)
+	{
+		model = crc_find_model(model_names[model_index]);
+		frame_len = frame_lens[model_index];
+		position_count = (uint32_t)(frame_len * 8 + model->width);
+
+		random_state = fill_crc_test_data(original_data, frame_len, random_state);
+		original_crc = crc_calculate(model, original_data, frame_len);
+
+		memcpy(frame_data, original_data, frame_len);
+		received_crc = original_crc;
+		if (crc_correct(model, frame_data, frame_len, &received_crc, 2) != 0)
+		{
+			printf("%s correction check failed, good frame\n", model->name);
+			return -1;
+		}
+
+		for (trial_index = 0; trial_index < 2 * position_count; trial_index++)
+		{
+			// every position once as a single bit error, then random pairs.
+			first_position = (trial_index < position_count) ? (uint32_t)trial_index : (crc_test_random(&random_state) >> 8) % position_count;
+			second_position = (first_position + 1 + (crc_test_random(&random_state) >> 8) % (position_count - 1)) % position_count;
+
+			memcpy(frame_data, original_data, frame_len);
+			received_crc = original_crc;
+			if (first_position < frame_len * 8)
+			{
+				frame_data[first_position / 8] ^= (uint8_t)(1 << (first_position % 8));
+			}
+			else
+			{
+				received_crc ^= (crc_value_t)1 << (first_position - frame_len * 8);
+			}
+			if (trial_index >= position_count)
+			{
+				if (second_position < frame_len * 8)
+				{
+					frame_data[second_position / 8] ^= (uint8_t)(1 << (second_position % 8));
+				}
+				else
+				{
+					received_crc ^= (crc_value_t)1 << (second_position - frame_len * 8);
+				}
+			}
+
+			result = crc_correct(model, frame_data, frame_len, &received_crc, (trial_index < position_count) ? 1 : 2);
+
+			// a fix has to be the right one, and a refusal has to leave the frame alone.
+			if ((result > 0 && (memcmp(frame_data, original_data, frame_len) != 0 || received_crc != original_crc)) ||
+				(result < 0 && memcmp(frame_data, original_data, frame_len) == 0 && received_crc == original_crc) || (result == 0 && model->width > CRC_WIDTH_8) ||
+				(model->width >= CRC_WIDTH_32 && result != ((trial_index < position_count) ? 1 : 2)) ||
+				(model->width == CRC_WIDTH_16 && trial_index < position_count && result != 1))
+			{
+				printf("%s correction check failed, bits %u %u, result %d\n", model->name, first_position, second_position, result);
+				return -1;
+			}
+		}
+	}
+
+	// a double bit error with max_bits 1 is left alone at HD 6, indexes are shared between models with the same
+	// polynomial and directions, and frames past CRC_CORRECT_MAX_LEN aren't indexed.
+	model = crc_find_model("CRC-32");
+	memcpy(frame_data, original_data, 64);
+	received_crc = crc_calculate(model, frame_data, 64);
+	frame_data[3] ^= 0x10;
+	frame_data[40] ^= 0x01;
+	if (crc_correct(model, frame_data, 64, &received_crc, 1) != -1 ||
+		crc_syndrome_index(model, 64) != crc_syndrome_index(crc_find_model("CRC-32/JAMCRC"), 64) ||
+		crc_syndrome_index(model, 64) == crc_syndrome_index(crc_find_model("CRC-32/BZIP2"), 64) ||
+		crc_syndrome_index(model, CRC_CORRECT_MAX_LEN + 1) != NULL)
+	{
+		printf("correction check failed\n");
+		return -1;
+	}
+
+	return 1; // ok.
+}
+
+
+// every catalogue model, window lengths 1 to past a slicing block: the rolling crc against crc_calculate() over every
+// window, and the boundary scan against the same windows tested one by one.
+int check_crc_rolling()
+{
+	static const size_t window_lens [] = {1, 4, 16, 48, 100};
+	static uint8_t data_array [600];
+	size_t positions [600];
+	size_t data_index, model_index, window_index, window_len, position_count, expected_count;
+	crc_value_t boundary_mask, rolled_crc, expected_crc;
+	crc_rolling_t rolling;
+	crc_model_t* model;
+
+	fill_crc_test_data(data_array, sizeof(data_array), 0x165667B1);
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+
+		for (window_index = 0; window_index < sizeof(window_lens) / sizeof(window_lens[0]); window_index++)
+		{
+			window_len = window_lens[window_index];
+			if (crc_rolling_init(&rolling, model, window_len) != 0)
+			{
+				printf("%s rolling check failed, init\n", model->name);
+				return -1;
+			}
+
+			rolled_crc = crc_rolling_start(&rolling, data_array);
+			for (data_index = window_len; ; data_index++)
+			{
+				expected_crc = crc_calculate(model, data_array + data_index - window_len, window_len);
+				if (rolled_crc != expected_crc)
+				{
+					printf("%s rolling check failed, window %zu at %zu: %llx, expected %llx\n", model->name, window_len, data_index,
+						(unsigned long long)rolled_crc, (unsigned long long)expected_crc);
+					return -1;
+				}
+				if (data_index == sizeof(data_array))
+				{
+					break;
+				}
+				rolled_crc = crc_rolling_roll(&rolling, data_array[data_index - window_len], data_array[data_index]);
+			}
+
+			// about one window in 8 is a boundary.
+			boundary_mask = (crc_value_t)0x7 << (model->width - 8);
+			position_count = crc_rolling_scan(&rolling, data_array, sizeof(data_array), boundary_mask, boundary_mask, positions, 600);
+			expected_count = 0;
+			for (data_index = window_len; data_index <= sizeof(data_array); data_index++)
+			{
+				if ((crc_calculate(model, data_array + data_index - window_len, window_len) & boundary_mask) != boundary_mask)
+				{
+					continue;
+				}
+				if (expected_count >= position_count || positions[expected_count] != data_index)
+				{
+					printf("%s rolling scan check failed, window %zu at %zu\n", model->name, window_len, data_index);
+					return -1;
+				}
+				expected_count++;
+			}
+			if (expected_count != position_count || position_count == 0 ||
+				crc_rolling_scan(&rolling, data_array, sizeof(data_array), boundary_mask, boundary_mask, positions, 1) != 1)
+			{
+				printf("%s rolling scan check failed, window %zu, %zu boundaries\n", model->name, window_len, position_count);
+				return -1;
+			}
+		}
+	}
+
+	if (crc_rolling_init(&rolling, crc_find_model("CRC-32"), 0) != -1)
+	{
+		printf("rolling check failed, empty window\n");
+		return -1;
+	}
+
+	return 1; // ok.
+}
+
+#ifdef USE_SPECIALIZED_MODELS
+// every specialized function against crc_calculate() on its catalogue model: lengths 0 to past two slicing blocks from
+// unaligned starts, an _update() split anywhere, and the fixed size keys.
+int check_crc_specialized()
+{
+	static uint8_t data_array [300];
+	size_t data_len, split_len;
+	crc_model_t* model;
+	int result = 1;
+
+	fill_crc_test_data(data_array, sizeof(data_array), 0x68E31DA4);
+
+#define CRC_CHECK_SPECIALIZED(name, model_name)																					\
+	model = crc_find_model(model_name);																							\
+	for (data_len = 0; data_len <= 40 && result == 1; data_len++)																\
+	{																															\
+		for (split_len = 0; split_len <= data_len; split_len += 3)																\
+		{																														\
+			if (name(data_array + data_len % 7, data_len) != crc_calculate(model, data_array + data_len % 7, data_len) ||		\
+				(name##_update(name##_update((crc_value_t)crc_register_init(model), data_array, split_len), data_array + split_len, data_len - split_len) ^	\
+					model->final_xor_value) != crc_calculate(model, data_array, data_len))										\
+			{																													\
+				printf("%s check failed, %u bytes split at %u\n", #name, (unsigned)data_len, (unsigned)split_len);				\
+				result = -1;																									\
+				break;																											\
+			}																													\
+		}																														\
+	}																															\
+	if (result == 1 && (name(data_array, sizeof(data_array)) != crc_calculate(model, data_array, sizeof(data_array)) ||			\
+						name##_4(data_array + 1) != crc_calculate(model, data_array + 1, 4) ||									\
+						name##_8(data_array + 2) != crc_calculate(model, data_array + 2, 8) ||									\
+						name##_16(data_array + 3) != crc_calculate(model, data_array + 3, 16)))									\
+	{																															\
+		printf("%s check failed, long message or fixed size keys\n", #name);													\
+		result = -1;																											\
+	}
+
+	CRC_CHECK_SPECIALIZED(crc8_smbus, "CRC-8")
+	CRC_CHECK_SPECIALIZED(crc8_darc, "CRC-8/DARC")
+	CRC_CHECK_SPECIALIZED(crc16_ccitt_false, "CRC-16/CCITT-FALSE")
+	CRC_CHECK_SPECIALIZED(crc16_arc, "ARC")
+	CRC_CHECK_SPECIALIZED(crc32_ieee, "CRC-32")
+	CRC_CHECK_SPECIALIZED(crc32_bzip2, "CRC-32/BZIP2")
+	CRC_CHECK_SPECIALIZED(crc32c, "CRC-32C")
+	CRC_CHECK_SPECIALIZED(crc64_xz, "CRC-64/XZ")
+
+#undef CRC_CHECK_SPECIALIZED
+
+	return result;
+}
+#endif // USE_SPECIALIZED_MODELS
+
+
+
+
+#ifdef USE_ENGINE_TUNING
+// crc_tune() with every engine agreeing, tuned crc_calculate() against the bitwise loop across all size classes, every usable
+// engine forced on every size class, and a crc_tune_save() / crc_tune_load() round trip (and a file from another cpu refused).
+// leaves the registry untuned.
+int check_crc_tuning()
+{
+	static const size_t data_lens [] = {0, 1, 3, 4, 15, 16, 63, 64, 255, 256, 1023, 1024, 4095, 4096, 16383, 16384, 70000};
+	static uint8_t data_array [70000 + 1];
+	static uint8_t saved_engines [CRC_CATALOGUE_SIZE][CRC_TUNE_BUCKETS];
+	size_t model_index, len_index;
+	crc_model_t* model;
+	crc_tables_t* tables;
+	FILE* tune_file;
+	uint8_t engine, bucket;
+	int result = 1;
+
+	fill_crc_test_data(data_array, sizeof(data_array), 0x7FEB352D);
+
+	if (crc_tune(NULL) != 1)
+	{
+		printf("tuning check failed, an engine disagreed\n");
+		result = -1;
+	}
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE && result == 1; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+		tables = (crc_tables_t*)crc_model_tables(model);
+
+		for (len_index = 0; len_index < sizeof(data_lens) / sizeof(data_lens[0]) && result == 1; len_index++)
+		{
+			if (crc_calculate(model, data_array + 1, data_lens[len_index]) != crc_calculate_bitwise(model, data_array + 1, data_lens[len_index]))
+			{
+				printf("%s tuning check failed, tuned crc of %u bytes\n", model->name, (unsigned)data_lens[len_index]);
+				result = -1;
+			}
+		}
+		memcpy(saved_engines[model_index], tables->tuned_engines, CRC_TUNE_BUCKETS);
+	}
+
+	// the file round trip, before the forced engines below overwrite the tuning.
+	tune_file = tmpfile();
+	if (result == 1 && (tune_file == NULL || crc_tune_save(tune_file) != 1))
+	{
+		printf("tuning check failed, couldn't save\n");
+		result = -1;
+	}
+	if (result == 1)
+	{
+		crc_tune_clear();
+		rewind(tune_file);
+		if (crc_tune_load(tune_file) != 1)
+		{
+			printf("tuning check failed, couldn't load what was saved\n");
+			result = -1;
+		}
+	}
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE && result == 1; model_index++)
+	{
+		if (memcmp(saved_engines[model_index], crc_model_tables(&crc_catalogue[model_index])->tuned_engines, CRC_TUNE_BUCKETS) != 0)
+		{
+			printf("%s tuning check failed, loaded engines differ from the saved ones\n", crc_catalogue[model_index].name);
+			result = -1;
+		}
+	}
+	if (tune_file != NULL)
+	{
+		fclose(tune_file);
+	}
+
+	tune_file = tmpfile();
+	if (result == 1 && tune_file != NULL)
+	{
+		fprintf(tune_file, "crickey-tune %d %d some_other_cpu\n", CRC_TUNE_FILE_VERSION, CRC_TUNE_BUCKETS);
+		rewind(tune_file);
+		if (crc_tune_load(tune_file) != -1)
+		{
+			printf("tuning check failed, a file from another cpu was taken\n");
+			result = -1;
+		}
+	}
+	if (tune_file != NULL)
+	{
+		fclose(tune_file);
+	}
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE && result == 1; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+		tables = (crc_tables_t*)crc_model_tables(model);
+
+		for (engine = CRC_ENGINE_BITWISE; engine < CRC_ENGINES && result == 1; engine++)
+		{
+			if (!crc_engine_usable((crc_engine_t)engine, tables))
+			{
+				continue;
+			}
+
+			for (bucket = 0; bucket < CRC_TUNE_BUCKETS; bucket++)
+			{
+				tables->tuned_engines[bucket] = engine;
+			}
+
+			for (len_index = 0; len_index < sizeof(data_lens) / sizeof(data_lens[0]) && result == 1; len_index += 3)
+			{
+				if (crc_calculate(model, data_array + 1, data_lens[len_index]) != crc_calculate_bitwise(model, data_array + 1, data_lens[len_index]))
+				{
+					printf("%s tuning check failed, %s engine on %u bytes\n", model->name, crc_engine_names[engine], (unsigned)data_lens[len_index]);
+					result = -1;
+				}
+			}
+		}
+	}
+
+	crc_tune_clear();
+
+	return result;
+}
+#endif // USE_ENGINE_TUNING
+///////////////////////////////////////////////////////////////////		MODEL FUNCTIONS --	///////////////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////		BENCHMARK FUNCTIONS ++	///////////////////////////////////////////////////////////////////
+#ifdef CRICKEY_BENCHMARK
+static const char* const crc_bench_engine_names [CRC_BENCH_ENGINES] =
+{
+	"bitwise", "nibble", "table", "slicing-4", "slicing-8", "slicing-16", "clmul", "hw", "model", "parallel"
+};
+
+
+// time stamp counter, for cycles/byte. that's reference cycles, so it's off by the turbo ratio, but stable between runs.
+static uint64_t crc_bench_cycles()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	return __builtin_ia32_rdtsc();
+#else
+	return 0;
+#endif // __GNUC__ && x86
+}
+
+
+// the bench engines that are one crc_engine_t each.
+static const crc_engine_t crc_bench_single_engines [CRC_BENCH_ENGINES] =
+{
+	CRC_ENGINE_BITWISE, CRC_ENGINE_NIBBLE, CRC_ENGINE_TABLE, CRC_ENGINE_SLICING_4, CRC_ENGINE_SLICING_8, CRC_ENGINE_SLICING_16, CRC_ENGINE_CLMUL, CRC_ENGINE_HW,
+	CRC_ENGINE_AUTO, CRC_ENGINE_AUTO
+};
+
+
+// can the engine run this model in this build, on this cpu.
+static int crc_bench_engine_usable(crc_bench_engine_t engine, crc_model_t* model)
+{
+	switch (engine)
+	{
+		case CRC_BENCH_BITWISE:
+		case CRC_BENCH_MODEL:
+		case CRC_BENCH_PARALLEL:	return 1;
+		default:					return crc_engine_usable(crc_bench_single_engines[engine], crc_model_tables(model));
+	}
+}
+
+
+// one crc of the buffer with the given engine, straight on the engine functions (no dispatch) where there's one.
+static crc_value_t crc_bench_engine_run(crc_bench_engine_t engine, crc_model_t* model, const uint8_t* byte_data, size_t data_len)
+{
+	switch (engine)
+	{
+		case CRC_BENCH_MODEL:		return crc_calculate(model, byte_data, data_len);
+		case CRC_BENCH_PARALLEL:	return crc_calculate_parallel(model, byte_data, data_len, 0, 0);
+		case CRC_BENCH_BITWISE:		return crc_calculate_bitwise(model, byte_data, data_len);
+		default:					return crc_register_final(model, crc_engine_update(crc_bench_single_engines[engine], crc_model_tables(model),
+																							crc_register_init(model), byte_data, data_len));
+	}
+}
+
+
+// runs the whole matrix. every engine result is checked against the model engine on the first (offset 0) run of each size,
+// a benchmark of a wrong answer is no use. returns -1 on a mismatch or if no buffer could be had.
+int run_crc_benchmark()
+{
+	static const size_t data_offsets [] = CRC_BENCH_OFFSETS;
+	uint64_t slowest_call_ns [CRC_BENCH_ENGINES];
+	uint8_t* data_buffer;
+	uint8_t* byte_data;
+	size_t max_len = CRC_BENCH_MAX_LEN, data_len, model_index, offset_index;
+	uint64_t calls, batch_calls, batch_index, start_ns, elapsed_ns, start_cycles, elapsed_cycles;
+	crc_bench_engine_t engine;
+	crc_model_t* model;
+	crc_value_t expected_crc;
+	volatile crc_value_t crc_sink = 0;
+#ifdef CRC_BENCH_JSON
+	int first_row = 1;
+#endif // CRC_BENCH_JSON
+
+	// the largest buffer there's memory for, plus room for the offsets and a cache line to align it on.
+	while ((data_buffer = malloc(max_len + 2 * CRC_CACHE_LINE_SIZE)) == NULL && max_len > CRC_BENCH_MIN_LEN)
+	{
+		max_len /= 2;
+	}
+	if (data_buffer == NULL)
+	{
+		fprintf(stderr, "no memory for the benchmark buffer\n");
+		return -1;
+	}
+	if (max_len != CRC_BENCH_MAX_LEN)
+	{
+		fprintf(stderr, "benchmark buffer cut down to %llu bytes\n", (unsigned long long)max_len);
+	}
+
+	byte_data = (uint8_t*)(((uintptr_t)data_buffer + CRC_CACHE_LINE_SIZE - 1) & ~(uintptr_t)(CRC_CACHE_LINE_SIZE - 1));
+	fill_crc_test_data(byte_data, max_len + CRC_CACHE_LINE_SIZE, 0x3C6EF372);
+
+#ifdef CRC_BENCH_JSON
+	printf("[\n");
+#else
+	printf("engine,model,width,size,offset,calls,ns_per_call,gb_per_s,cycles_per_byte\n");
+#endif // CRC_BENCH_JSON
+
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		model = &crc_catalogue[model_index];
+		memset(slowest_call_ns, 0, sizeof(slowest_call_ns));
+
+		for (data_len = CRC_BENCH_MIN_LEN; data_len <= max_len; data_len = (data_len > max_len / 4 && data_len < max_len) ? max_len : data_len * 4)
+		{
+			expected_crc = crc_calculate(model, byte_data, data_len);
+
+			for (engine = 0; engine < CRC_BENCH_ENGINES; engine++)
+			{
+				// one call at the last size took long enough that this one (4x the data) would blow the budget.
+				if (!crc_bench_engine_usable(engine, model) || slowest_call_ns[engine] * 4 > CRC_BENCH_MAX_CALL_NS)
+				{
+					continue;
+				}
+
+				if (crc_bench_engine_run(engine, model, byte_data, data_len) != expected_crc)
+				{
+					fprintf(stderr, "%s: %s engine mismatch, len %llu\n", model->name, crc_bench_engine_names[engine], (unsigned long long)data_len);
+					free(data_buffer);
+					return -1;
+				}
+
+				for (offset_index = 0; offset_index < sizeof(data_offsets) / sizeof(data_offsets[0]); offset_index++)
+				{
+					// calls in doubling batches, so the clock is read a handful of times and not once per 1 byte call.
+					calls = 0;
+					start_ns = crc_monotonic_ns();
+					start_cycles = crc_bench_cycles();
+					for (batch_calls = 1; ; batch_calls *= 2)
+					{
+						for (batch_index = 0; batch_index < batch_calls; batch_index++)
+						{
+							crc_sink ^= crc_bench_engine_run(engine, model, byte_data + data_offsets[offset_index], data_len);
+						}
+						calls += batch_calls;
+						elapsed_ns = crc_monotonic_ns() - start_ns;
+
+						if (elapsed_ns >= CRC_BENCH_MIN_NS)
+						{
+							break;
+						}
+					}
+					elapsed_cycles = crc_bench_cycles() - start_cycles;
+
+					if (elapsed_ns / calls > slowest_call_ns[engine])
+					{
+						slowest_call_ns[engine] = elapsed_ns / calls;
+					}
+
+#ifdef CRC_BENCH_JSON
+					printf("%s\t{\"engine\": \"%s\", \"model\": \"%s\", \"width\": %d, \"size\": %llu, \"offset\": %u, \"calls\": %llu, "
+							"\"ns_per_call\": %.2f, \"gb_per_s\": %.4f, \"cycles_per_byte\": %.4f}",
+							first_row ? "" : ",\n",
+#else
+					printf("%s,%s,%d,%llu,%u,%llu,%.2f,%.4f,%.4f\n",
+#endif // CRC_BENCH_JSON
+							crc_bench_engine_names[engine], model->name, model->width, (unsigned long long)data_len, (unsigned)data_offsets[offset_index],
+							(unsigned long long)calls, (double)elapsed_ns / calls, (double)data_len * calls / elapsed_ns,
+							(double)elapsed_cycles / ((double)data_len * calls));
+#ifdef CRC_BENCH_JSON
+					first_row = 0;
+#endif // CRC_BENCH_JSON
+				}
+			}
+
+			if (data_len == max_len)
+			{
+				break;
+			}
+		}
+	}
+
+#ifdef CRC_BENCH_JSON
+	printf("\n]\n");
+#endif // CRC_BENCH_JSON
+
+	free(data_buffer);
+	(void)crc_sink;
+
+	return 1;
+}
+#endif // CRICKEY_BENCHMARK
+///////////////////////////////////////////////////////////////////		BENCHMARK FUNCTIONS --	///////////////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////		MANIFEST FUNCTIONS ++	///////////////////////////////////////////////////////////////////
+#ifdef USE_MANIFEST
+void crc_manifest_init(crc_manifest_t* manifest, crc_model_t* model)
+{
+	memset(manifest, 0, sizeof(*manifest));
+	manifest->model = model;
+	manifest->chunk_len = CRC_MANIFEST_CHUNK_LEN;
+	manifest->batch_len = CRC_MANIFEST_BATCH_LEN;
+}
+
+
+void crc_manifest_free(crc_manifest_t* manifest)
+{
+	size_t entry_index;
+
+	for (entry_index = 0; entry_index < manifest->entry_count; entry_index++)
+	{
+		free(manifest->entries[entry_index].path);
+		free(manifest->entries[entry_index].chunk_crcs);
+	}
+	free(manifest->entries);
+
+	manifest->entries = NULL;
+	manifest->entry_count = 0;
+	manifest->entry_capacity = 0;
+}
+
+
+// appends one file, the path is copied. -1 (errno ENOMEM) if memory ran out.
+int crc_manifest_add(crc_manifest_t* manifest, const char* path, uint64_t file_len, crc_value_t expected_crc)
+{
+	crc_manifest_entry_t* entries;
+	crc_manifest_entry_t* entry;
+	size_t entry_capacity;
+
+	if (manifest->entry_count == manifest->entry_capacity)
+	{
+		entry_capacity = (manifest->entry_capacity == 0) ? 1024 : manifest->entry_capacity * 2;
+		entries = realloc(manifest->entries, entry_capacity * sizeof(crc_manifest_entry_t));
+		if (entries == NULL)
+		{
+			errno = ENOMEM;
+			return -1;
+		}
+		manifest->entries = entries;
+		manifest->entry_capacity = entry_capacity;
+	}
+
+	entry = &manifest->entries[manifest->entry_count];
+	memset(entry, 0, sizeof(*entry));
+	entry->path = strdup(path);
+	if (entry->path == NULL)
+	{
+		errno = ENOMEM;
+		return -1;
+	}
+	entry->file_len = file_len;
+	entry->expected_crc = expected_crc;
+	manifest->entry_count++;
+
+	return 0;
+}
+
+
+static int crc_manifest_entry_compare(const void* entry_a, const void* entry_b)
+{
+	return strcmp(((const crc_manifest_entry_t*)entry_a)->path, ((const crc_manifest_entry_t*)entry_b)->path);
+}
+
+
+// adds the regular files under dir_path, depth first. symlinks aren't followed, so a link loop can't trap the walk, and
+// anything that isn't a regular file or a directory is left out. returns the number of directories and files that
+// couldn't be looked at (each one reported on stderr), -1 if memory ran out.
+static int crc_manifest_walk_directory(crc_manifest_t* manifest, char* path_buffer, size_t path_len, size_t path_max)
+{
+	struct dirent* dir_entry;
+	struct stat file_stat;
+	DIR* dir;
+	size_t name_len;
+	int unreadable = 0, result;
+
+	dir = opendir(path_buffer);
+	if (dir == NULL)
+	{
+		fprintf(stderr, "crickey: %s: %s\n", path_buffer, strerror(errno));
+		return 1;
+	}
+
+	// "dir" and "dir/" both give "dir/name".
+	if (path_len > 0 && path_buffer[path_len - 1] != '/')
+	{
+		path_buffer[path_len++] = '/';
+	}
+
+	while ((dir_entry = readdir(dir)) != NULL)
+	{
+		if (strcmp(dir_entry->d_name, ".") == 0 || strcmp(dir_entry->d_name, "..") == 0)
+		{
+			continue;
+		}
+
+		name_len = strlen(dir_entry->d_name);
+		if (path_len + name_len + 2 > path_max)
+		{
+			path_buffer[path_len] = '\0';
+			fprintf(stderr, "crickey: %s%s: %s\n", path_buffer, dir_entry->d_name, strerror(ENAMETOOLONG));
+			unreadable++;
+			continue;
+		}
+		memcpy(path_buffer + path_len, dir_entry->d_name, name_len + 1);
+
+		if (lstat(path_buffer, &file_stat) != 0)
+		{
+			fprintf(stderr, "crickey: %s: %s\n", path_buffer, strerror(errno));
+			unreadable++;
+		}
+		else if (S_ISDIR(file_stat.st_mode))
+		{
+			result = crc_manifest_walk_directory(manifest, path_buffer, path_len + name_len, path_max);
+			if (result < 0)
+			{
+				closedir(dir);
+				return -1;
+			}
+			unreadable += result;
+		}
+		else if (S_ISREG(file_stat.st_mode))
+		{
+			if (crc_manifest_add(manifest, path_buffer, (uint64_t)file_stat.st_size, 0) != 0)
+			{
+				closedir(dir);
+				return -1;
+			}
+		}
+	}
+
+	closedir(dir);
+
+	return unreadable;
+}
+
+
+// adds every regular file under path (or path itself, if it's a file), sorted by name so the same tree always gives
+// the same manifest. the sizes are taken here, the run cuts the chunks on them.
+int crc_manifest_walk(crc_manifest_t* manifest, const char* path)
+{
+	char path_buffer [CRC_CLI_LINE_MAX];
+	struct stat file_stat;
+	size_t first_entry = manifest->entry_count;
+	size_t path_len = strlen(path);
+	int unreadable;
+
+	if (stat(path, &file_stat) != 0)
+	{
+		fprintf(stderr, "crickey: %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+
+	if (!S_ISDIR(file_stat.st_mode))
+	{
+		return crc_manifest_add(manifest, path, S_ISREG(file_stat.st_mode) ? (uint64_t)file_stat.st_size : CRC_MANIFEST_LEN_UNKNOWN, 0);
+	}
+
+	if (path_len + 2 > sizeof(path_buffer))
+	{
+		fprintf(stderr, "crickey: %s: %s\n", path, strerror(ENAMETOOLONG));
+		return 1;
+	}
+	memcpy(path_buffer, path, path_len + 1);
+
+	unreadable = crc_manifest_walk_directory(manifest, path_buffer, path_len, sizeof(path_buffer));
+	if (unreadable >= 0)
+	{
+		qsort(manifest->entries + first_entry, manifest->entry_count - first_entry, sizeof(crc_manifest_entry_t), crc_manifest_entry_compare);
+	}
+
+	return unreadable;
+}
+
+
+// reads a manifest as crickey -r (or plain crickey) prints it, "<crc>  <path>" per line, the crcs go to expected_crc.
+// returns the number of lines that aren't in that format (empty ones aside), -1 if memory ran out.
+int crc_manifest_read(crc_manifest_t* manifest, FILE* list_file)
+{
+	char line [CRC_CLI_LINE_MAX];
+	char* hex_end;
+	size_t line_len;
+	unsigned long long expected_crc;
+	int malformed = 0;
+
+	while (fgets(line, sizeof(line), list_file) != NULL)
+	{
+		line_len = strlen(line);
+		while (line_len > 0 && (line[line_len - 1] == '\n' || line[line_len - 1] == '\r'))
+		{
+			line[--line_len] = '\0';
+		}
+
+		// "<hex> <space or *><name>", the second character is the sha256sum text/binary mark.
+		errno = 0;
+		expected_crc = strtoull(line, &hex_end, 16);
+		if (errno != 0 || hex_end == line || hex_end[0] != ' ' || (hex_end[1] != ' ' && hex_end[1] != '*') || hex_end[2] == '\0')
+		{
+			if (line_len > 0)
+			{
+				malformed++;
+			}
+			continue;
+		}
+
+		if (crc_manifest_add(manifest, hex_end + 2, CRC_MANIFEST_LEN_UNKNOWN, (crc_value_t)expected_crc) != 0)
+		{
+			return -1;
+		}
+	}
+
+	return malformed;
+}
+
+
+// one task: a run of whole files [first_entry, entry_end), or one chunk of a chunked file (entry_end == first_entry + 1).
+typedef struct
+{
+	size_t first_entry;
+	size_t entry_end;
+	uint32_t chunk_index;
+	uint64_t task_len;						// bytes, the tasks are dealt out biggest first.
+} crc_manifest_task_t;
+
+// one thread's queue. the owner takes from head, thieves from tail, both under the lock: a task is milliseconds of
+// reading, the lock is nothing next to that.
+typedef struct
+{
+	pthread_mutex_t lock;
+	crc_manifest_task_t* tasks;
+	size_t head;
+	size_t tail;
+} crc_manifest_queue_t;
+
+typedef struct
+{
+	crc_manifest_t* manifest;
+	crc_manifest_queue_t* queues;
+	uint8_t queue_count;
+	uint8_t queue_index;					// the thread's own queue.
+	uint8_t* read_buffer;					// CRC_CLI_READ_BLOCK, page aligned.
+} crc_manifest_worker_t;
+
+
+static int crc_manifest_task_compare(const void* task_a, const void* task_b)
+{
+	uint64_t len_a = ((const crc_manifest_task_t*)task_a)->task_len;
+	uint64_t len_b = ((const crc_manifest_task_t*)task_b)->task_len;
+
+	return (len_a < len_b) ? 1 : (len_a > len_b) ? -1 : 0;
+}
+
+
+// data_len bytes that were read through the crc, runs of all zero CRC_MANIFEST_ZERO_RUN_LEN pages with crc_update_zeros().
+// a page with data in it is told from a zero one at its first non-zero byte, so data costs next to nothing extra.
+static void crc_manifest_update_data(crc_context_t* context, const uint8_t* byte_data, size_t data_len)
+{
+	size_t run_start = 0, zero_len = 0, page_offset;
+
+	for (page_offset = 0; page_offset + CRC_MANIFEST_ZERO_RUN_LEN <= data_len; page_offset += CRC_MANIFEST_ZERO_RUN_LEN)
+	{
+		if (byte_data[page_offset] != 0 || memcmp(byte_data + page_offset, byte_data + page_offset + 1, CRC_MANIFEST_ZERO_RUN_LEN - 1) != 0)
+		{
+			continue;
+		}
+
+		if (page_offset != run_start + zero_len)
+		{
+			crc_update_zeros(context, zero_len);
+			crc_update(context, byte_data + run_start + zero_len, page_offset - run_start - zero_len);
+			run_start = page_offset;
+			zero_len = 0;
+		}
+		zero_len += CRC_MANIFEST_ZERO_RUN_LEN;
+	}
+
+	crc_update_zeros(context, zero_len);
+	crc_update(context, byte_data + run_start + zero_len, data_len - run_start - zero_len);
+}
+
+
+// crc of data_len bytes of fd from file_offset (to the end of the file with CRC_MANIFEST_LEN_UNKNOWN), in
+// CRC_CLI_READ_BLOCK preads, holes skipped (see CRC_MANIFEST_ZERO_RUN_LEN). -1 with errno set if a read fails, or EIO
+// if the file ends early.
+static int crc_manifest_read_range(crc_model_t* model, int fd, uint64_t file_offset, uint64_t data_len, uint8_t* read_buffer, crc_value_t* calculated_crc)
+{
+	crc_context_t context;
+	ssize_t read_len;
+	size_t block_len;
+#ifdef SEEK_HOLE
+	uint64_t data_end = file_offset, hole_len;		// data_end: end of the data extent, once file_offset is in one.
+	off_t extent_offset;
+	uint8_t sparse = 1;
+#endif // SEEK_HOLE
+
+#ifdef POSIX_FADV_SEQUENTIAL
+	posix_fadvise(fd, (off_t)file_offset, (data_len == CRC_MANIFEST_LEN_UNKNOWN) ? 0 : (off_t)data_len, POSIX_FADV_SEQUENTIAL);
+#endif // POSIX_FADV_SEQUENTIAL
+
+	crc_init(&context, model);
+	while (data_len != 0)
+	{
+		block_len = (data_len < CRC_CLI_READ_BLOCK) ? (size_t)data_len : CRC_CLI_READ_BLOCK;
+
+#ifdef SEEK_HOLE
+		if (sparse && file_offset >= data_end)
+		{
+			// SEEK_DATA from inside a hole is where it ends, ENXIO if it runs to the end of the file.
+			extent_offset = lseek(fd, (off_t)file_offset, SEEK_DATA);
+			if (extent_offset < 0 && errno == ENXIO)
+			{
+				extent_offset = lseek(fd, 0, SEEK_END);
+			}
+			if (extent_offset > 0 && (uint64_t)extent_offset > file_offset)
+			{
+				hole_len = (uint64_t)extent_offset - file_offset;
+				if (data_len != CRC_MANIFEST_LEN_UNKNOWN && hole_len > data_len)
+				{
+					hole_len = data_len;
+				}
+
+				crc_update_zeros(&context, hole_len);
+				file_offset += hole_len;
+				if (data_len != CRC_MANIFEST_LEN_UNKNOWN)
+				{
+					data_len -= hole_len;
+				}
+				continue;
+			}
+
+			// no extents on this file system (or the end of the file): plain reads from here on.
+			extent_offset = lseek(fd, (off_t)file_offset, SEEK_HOLE);
+			if (extent_offset > 0 && (uint64_t)extent_offset > file_offset)
+			{
+				data_end = (uint64_t)extent_offset;
+			}
+			else
+			{
+				sparse = 0;
+			}
+		}
+		if (sparse && data_end - file_offset < block_len)
+		{
+			block_len = (size_t)(data_end - file_offset);
+		}
+#endif // SEEK_HOLE
+
+		read_len = pread(fd, read_buffer, block_len, (off_t)file_offset);
+		if (read_len < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return -1;
+		}
+		if (read_len == 0)
+		{
+			if (data_len == CRC_MANIFEST_LEN_UNKNOWN)
+			{
+				break;
+			}
+			errno = EIO; // shorter than when the walk saw it.
+			return -1;
+		}
+
+		crc_manifest_update_data(&context, read_buffer, (size_t)read_len);
+		file_offset += (uint64_t)read_len;
+		if (data_len != CRC_MANIFEST_LEN_UNKNOWN)
+		{
+			data_len -= (uint64_t)read_len;
+		}
+	}
+
+	*calculated_crc = crc_final(&context);
+
+	return 0;
+}
+
+
+// one chunk of a chunked file. the chunk that finishes last puts the file crc together from all of them.
+static void crc_manifest_run_chunk(crc_manifest_t* manifest, crc_manifest_entry_t* entry, uint32_t chunk_index, uint8_t* read_buffer)
+{
+	uint64_t chunk_offset = (uint64_t)chunk_index * manifest->chunk_len;
+	uint64_t chunk_len = (chunk_index == entry->chunk_count - 1) ? entry->file_len - chunk_offset : manifest->chunk_len;
+	crc_value_t calculated_crc;
+	int fd;
+
+	fd = open(entry->path, O_RDONLY | O_BINARY);
+	if (fd < 0 || crc_manifest_read_range(manifest->model, fd, chunk_offset, chunk_len, read_buffer, &entry->chunk_crcs[chunk_index]) != 0)
+	{
+		__atomic_store_n(&entry->error, errno, __ATOMIC_RELAXED);
+	}
+	if (fd >= 0)
+	{
+		close(fd);
+	}
+
+	// acq_rel: the last one sees every other chunk's crc (and error).
+	if (__atomic_sub_fetch(&entry->chunks_left, 1, __ATOMIC_ACQ_REL) != 0)
+	{
+		return;
+	}
+
+	calculated_crc = entry->chunk_crcs[0];
+	for (chunk_index = 1; chunk_index < entry->chunk_count; chunk_index++)
+	{
+		chunk_offset = (uint64_t)chunk_index * manifest->chunk_len;
+		chunk_len = (chunk_index == entry->chunk_count - 1) ? entry->file_len - chunk_offset : manifest->chunk_len;
+		calculated_crc = crc_combine(manifest->model, calculated_crc, entry->chunk_crcs[chunk_index], chunk_len);
+	}
+	entry->calculated_crc = calculated_crc;
+}
+
+
+static void crc_manifest_run_task(crc_manifest_t* manifest, const crc_manifest_task_t* task, uint8_t* read_buffer)
+{
+	crc_manifest_entry_t* entry;
+	size_t entry_index;
+	int fd;
+
+	if (manifest->entries[task->first_entry].chunk_count != 0)
+	{
+		crc_manifest_run_chunk(manifest, &manifest->entries[task->first_entry], task->chunk_index, read_buffer);
+		return;
+	}
+
+	for (entry_index = task->first_entry; entry_index < task->entry_end; entry_index++)
+	{
+		entry = &manifest->entries[entry_index];
+
+		fd = open(entry->path, O_RDONLY | O_BINARY);
+		if (fd < 0 || crc_manifest_read_range(manifest->model, fd, 0, CRC_MANIFEST_LEN_UNKNOWN, read_buffer, &entry->calculated_crc) != 0)
+		{
+			entry->error = errno;
+		}
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+	}
+}
+
+
+// the next task for a worker: from the front of its own queue, else from the back of the first other queue that has any.
+// 0 once every queue is empty, nothing new gets queued during a run.
+static int crc_manifest_next_task(crc_manifest_worker_t* worker, crc_manifest_task_t* task)
+{
+	crc_manifest_queue_t* queue;
+	uint8_t queue_step;
+	int found = 0;
+
+	for (queue_step = 0; queue_step < worker->queue_count && !found; queue_step++)
+	{
+		queue = &worker->queues[(worker->queue_index + queue_step) % worker->queue_count];
+
+		pthread_mutex_lock(&queue->lock);
+		if (queue->head < queue->tail)
+		{
+			*task = (queue_step == 0) ? queue->tasks[queue->head++] : queue->tasks[--queue->tail];
+			found = 1;
+		}
+		pthread_mutex_unlock(&queue->lock);
+	}
+
+	return found;
+}
+
+
+static void* crc_manifest_worker_thread(void* thread_argument)
+{
+	crc_manifest_worker_t* worker = thread_argument;
+	crc_manifest_task_t task;
+
+	while (crc_manifest_next_task(worker, &task))
+	{
+		crc_manifest_run_task(worker->manifest, &task, worker->read_buffer);
+	}
+
+	return NULL;
+}
+
+
+// cuts the entries into tasks (see MANIFEST DEFINES), biggest first. entries without a size from the walk are looked at
+// here, one that can't be gets its error and no task. NULL if memory ran out.
+static crc_manifest_task_t* crc_manifest_plan(crc_manifest_t* manifest, size_t* task_count)
+{
+	crc_manifest_task_t* tasks;
+	crc_manifest_entry_t* entry;
+	struct stat file_stat;
+	size_t entry_index, task_capacity = 0, batch_first = 0;
+	uint64_t batch_len = 0;
+	uint32_t chunk_index;
+
+	*task_count = 0;
+
+	for (entry_index = 0; entry_index < manifest->entry_count; entry_index++)
+	{
+		entry = &manifest->entries[entry_index];
+		entry->error = 0;
+		entry->chunk_count = 0;
+
+		if (entry->file_len == CRC_MANIFEST_LEN_UNKNOWN && stat(entry->path, &file_stat) == 0 && S_ISREG(file_stat.st_mode))
+		{
+			entry->file_len = (uint64_t)file_stat.st_size;
+		}
+
+		if (entry->file_len != CRC_MANIFEST_LEN_UNKNOWN && entry->file_len > 2 * manifest->chunk_len &&
+			(entry->file_len + manifest->chunk_len - 1) / manifest->chunk_len <= UINT32_MAX)
+		{
+			entry->chunk_count = (uint32_t)((entry->file_len + manifest->chunk_len - 1) / manifest->chunk_len);
+			free(entry->chunk_crcs);
+			entry->chunk_crcs = calloc(entry->chunk_count, sizeof(crc_value_t));
+			if (entry->chunk_crcs == NULL)
+			{
+				return NULL;
+			}
+			entry->chunks_left = entry->chunk_count;
+			task_capacity += entry->chunk_count;
+		}
+		else
+		{
+			task_capacity++; // a batch of one at most.
+		}
+	}
+
+	tasks = malloc((task_capacity + 1) * sizeof(crc_manifest_task_t));
+	if (tasks == NULL)
+	{
+		return NULL;
+	}
+
+	// chunked files break a batch, a batch is closed once it's long enough or has enough files.
+	for (entry_index = 0; entry_index <= manifest->entry_count; entry_index++)
+	{
+		entry = (entry_index < manifest->entry_count) ? &manifest->entries[entry_index] : NULL;
+
+		if (batch_first < entry_index && (entry == NULL || entry->chunk_count != 0 ||
+			batch_len >= manifest->batch_len || entry_index - batch_first >= CRC_MANIFEST_BATCH_FILES))
+		{
+			tasks[*task_count].first_entry = batch_first;
+			tasks[*task_count].entry_end = entry_index;
+			tasks[*task_count].chunk_index = 0;
+			tasks[*task_count].task_len = batch_len;
+			(*task_count)++;
+			batch_first = entry_index;
+			batch_len = 0;
+		}
+
+		if (entry == NULL)
+		{
+			break;
+		}
+
+		if (entry->chunk_count != 0)
+		{
+			for (chunk_index = 0; chunk_index < entry->chunk_count; chunk_index++)
+			{
+				tasks[*task_count].first_entry = entry_index;
+				tasks[*task_count].entry_end = entry_index + 1;
+				tasks[*task_count].chunk_index = chunk_index;
+				tasks[*task_count].task_len = manifest->chunk_len;
+				(*task_count)++;
+			}
+			batch_first = entry_index + 1;
+		}
+		else
+		{
+			batch_len += (entry->file_len == CRC_MANIFEST_LEN_UNKNOWN) ? 0 : entry->file_len;
+		}
+	}
+
+	qsort(tasks, *task_count, sizeof(crc_manifest_task_t), crc_manifest_task_compare);
+
+	return tasks;
+}
+
+
+// checksums every entry of the manifest on thread_count threads (0: CRC_MANIFEST_THREADS_PER_CPU per online cpu), the
+// calling thread is one of them. returns the number of entries that couldn't be read (error set), -1 if memory ran out.
+int crc_manifest_run(crc_manifest_t* manifest, uint8_t thread_count)
+{
+	crc_manifest_worker_t workers [CRC_PARALLEL_MAX_THREADS];
+	crc_manifest_queue_t queues [CRC_PARALLEL_MAX_THREADS];
+	pthread_t threads [CRC_PARALLEL_MAX_THREADS];
+	uint8_t thread_started [CRC_PARALLEL_MAX_THREADS] = {0};
+	uint8_t* read_memory [CRC_PARALLEL_MAX_THREADS] = {NULL};
+	crc_manifest_task_t* tasks;
+	size_t task_count, task_index, queue_len, entry_index;
+	uint8_t worker_index;
+	int unreadable = 0, result = 0;
+
+	// readers wait on the disk, so CRC_MANIFEST_THREADS_PER_CPU of them per cpu, still within CRC_PARALLEL_MAX_THREADS.
+	if (thread_count == 0)
+	{
+		thread_count = crc_parallel_thread_count(0, CRC_PARALLEL_MAX_THREADS / CRC_MANIFEST_THREADS_PER_CPU, 1) * CRC_MANIFEST_THREADS_PER_CPU;
+	}
+
+	tasks = crc_manifest_plan(manifest, &task_count);
+	if (tasks == NULL)
+	{
+		errno = ENOMEM;
+		return -1;
+	}
+	// no more threads than tasks.
+	thread_count = crc_parallel_thread_count(thread_count, task_count, 1);
+
+	// look the tables up once here, not in every thread.
+	(void)crc_model_tables(manifest->model);
+
+	// dealt out round robin, biggest first: every queue starts on big tasks and ends on small ones, the small ones at the
+	// back are what the thieves take.
+	queue_len = (task_count + thread_count - 1) / thread_count;
+	for (worker_index = 0; worker_index < thread_count; worker_index++)
+	{
+		queues[worker_index].tasks = malloc((queue_len + 1) * sizeof(crc_manifest_task_t));
+		read_memory[worker_index] = malloc(CRC_CLI_READ_BLOCK + CRC_CLI_READ_ALIGN - 1);
+		if (queues[worker_index].tasks == NULL || read_memory[worker_index] == NULL)
+		{
+			result = -1;
+		}
+		pthread_mutex_init(&queues[worker_index].lock, NULL);
+		queues[worker_index].head = 0;
+		queues[worker_index].tail = 0;
+
+		workers[worker_index].manifest = manifest;
+		workers[worker_index].queues = queues;
+		workers[worker_index].queue_count = thread_count;
+		workers[worker_index].queue_index = worker_index;
+		workers[worker_index].read_buffer = (uint8_t*)(((uintptr_t)read_memory[worker_index] + CRC_CLI_READ_ALIGN - 1) & ~(uintptr_t)(CRC_CLI_READ_ALIGN - 1));
+	}
+
+	if (result == 0)
+	{
+		for (task_index = 0; task_index < task_count; task_index++)
+		{
+			queues[task_index % thread_count].tasks[queues[task_index % thread_count].tail++] = tasks[task_index];
+		}
+
+		// a thread that can't be started just leaves its queue to be stolen.
+		for (worker_index = 1; worker_index < thread_count; worker_index++)
+		{
+			thread_started[worker_index] = (pthread_create(&threads[worker_index], NULL, crc_manifest_worker_thread, &workers[worker_index]) == 0);
+		}
+
+		crc_manifest_worker_thread(&workers[0]);
+
+		for (worker_index = 1; worker_index < thread_count; worker_index++)
+		{
+			if (thread_started[worker_index])
+			{
+				pthread_join(threads[worker_index], NULL);
+			}
+		}
+	}
+
+	for (worker_index = 0; worker_index < thread_count; worker_index++)
+	{
+		pthread_mutex_destroy(&queues[worker_index].lock);
+		free(queues[worker_index].tasks);
+		free(read_memory[worker_index]);
+	}
+	free(tasks);
+
+	if (result != 0)
+	{
+		errno = ENOMEM;
+		return -1;
+	}
+
+	for (entry_index = 0; entry_index < manifest->entry_count; entry_index++)
+	{
+		unreadable += (manifest->entries[entry_index].error != 0);
+	}
+
+	return unreadable;
+}
+
+
+// the manifest as crickey prints it, "<crc>  <path>" per line, entries that couldn't be read are left out.
+void crc_manifest_write(const crc_manifest_t* manifest, FILE* list_file)
+{
+	size_t entry_index;
+
+	for (entry_index = 0; entry_index < manifest->entry_count; entry_index++)
+	{
+		if (manifest->entries[entry_index].error == 0)
+		{
+			fprintf(list_file, "%0*llx  %s\n", manifest->model->width / 4, (unsigned long long)manifest->entries[entry_index].calculated_crc,
+					manifest->entries[entry_index].path);
+		}
+	}
+}
+
+
+// a small tree with files on both sides of the batch and chunk limits (both turned down to keep it small), a symlink and
+// an empty directory, run on several thread counts against crc_calculate() of the contents, then written out, damaged,
+// and checked back.
+int check_crc_manifest()
+{
+	static const size_t file_lens [] = {0, 1, 15, 100, 999, 4096, 6000, 9999, 10000, 10001, 25013, 40000, 77777};
+	static const char* const dir_names [] = {"", "/a", "/a/b", "/c", "/d"};
+	static const uint8_t thread_counts [] = {1, 3, 8, 0};
+	char root_path [] = "/tmp/crickey-manifest-XXXXXX";
+	char path [CRC_CLI_LINE_MAX];
+	char link_path [CRC_CLI_LINE_MAX];
+	uint8_t* file_data;
+	crc_value_t file_crcs [40];
+	crc_manifest_t manifest, checked_manifest;
+	crc_model_t* model = crc_find_model("CRC-32C");
+	FILE* file;
+	FILE* list_file;
+	uint32_t random_state = 0x4F1BBCDC;
+	size_t file_index, entry_index, thread_index, file_count = 40, data_len;
+	int result = 1, byte_value;
+
+	crc_manifest_init(&manifest, model);
+	file_data = malloc(77777);
+	if (file_data == NULL || mkdtemp(root_path) == NULL)
+	{
+		printf("manifest check: no temp directory\n");
+		free(file_data);
+		return -1;
+	}
+
+	for (file_index = 1; file_index < sizeof(dir_names) / sizeof(dir_names[0]); file_index++)
+	{
+		snprintf(path, sizeof(path), "%s%s", root_path, dir_names[file_index]);
+		mkdir(path, 0700);
+	}
+
+	// file names sort in creation order: f00 .. f39, so entry i of the walk is file i of its directory.
+	for (file_index = 0; file_index < file_count; file_index++)
+	{
+		data_len = file_lens[file_index % (sizeof(file_lens) / sizeof(file_lens[0]))];
+		random_state = fill_crc_test_data(file_data, data_len, random_state);
+		file_crcs[file_index] = crc_calculate(model, file_data, data_len);
+
+		snprintf(path, sizeof(path), "%s%s/f%02u", root_path, dir_names[file_index % 4], (unsigned)file_index);
+		file = fopen(path, "wb");
+		if (file == NULL || fwrite(file_data, 1, data_len, file) != data_len)
+		{
+			result = -1;
+		}
+		if (file != NULL)
+		{
+			fclose(file);
+		}
+	}
+	snprintf(path, sizeof(path), "%s/a/f01", root_path);
+	snprintf(link_path, sizeof(link_path), "%s/link", root_path);
+	if (symlink(path, link_path) != 0)
+	{
+		result = -1;
+	}
+
+	for (thread_index = 0; thread_index < sizeof(thread_counts) / sizeof(thread_counts[0]) && result == 1; thread_index++)
+	{
+		crc_manifest_init(&manifest, model);
+		manifest.chunk_len = 4096;
+		manifest.batch_len = 20000;
+
+		if (crc_manifest_walk(&manifest, root_path) != 0 || manifest.entry_count != file_count ||
+			crc_manifest_run(&manifest, thread_counts[thread_index]) != 0)
+		{
+			printf("manifest check failed, walk or run, %u threads\n", thread_counts[thread_index]);
+			result = -1;
+		}
+
+		for (entry_index = 0; entry_index < manifest.entry_count && result == 1; entry_index++)
+		{
+			file_index = (size_t)atoi(strrchr(manifest.entries[entry_index].path, '/') + 2);
+			if (file_index >= file_count || manifest.entries[entry_index].calculated_crc != file_crcs[file_index] ||
+				(entry_index > 0 && strcmp(manifest.entries[entry_index - 1].path, manifest.entries[entry_index].path) >= 0))
+			{
+				printf("manifest check failed, %s, %u threads\n", manifest.entries[entry_index].path, thread_counts[thread_index]);
+				result = -1;
+			}
+		}
+
+		if (thread_counts[thread_index] != 0)
+		{
+			crc_manifest_free(&manifest);
+		}
+	}
+
+	// write it out, change one byte of a chunked file (f12, 77777 bytes), drop a small one (f05), read it back and check.
+	list_file = tmpfile();
+	if (result == 1 && list_file != NULL)
+	{
+		crc_manifest_write(&manifest, list_file);
+		rewind(list_file);
+
+		snprintf(path, sizeof(path), "%s%s/f12", root_path, dir_names[12 % 4]);
+		file = fopen(path, "r+b");
+		if (file != NULL)
+		{
+			fseek(file, 50000, SEEK_SET);
+			byte_value = fgetc(file);
+			fseek(file, 50000, SEEK_SET);
+			fputc(byte_value ^ 0xFF, file);
+			fclose(file);
+		}
+		snprintf(path, sizeof(path), "%s%s/f05", root_path, dir_names[5 % 4]);
+		unlink(path);
+
+		crc_manifest_init(&checked_manifest, model);
+		checked_manifest.chunk_len = 4096;
+		if (crc_manifest_read(&checked_manifest, list_file) != 0 || checked_manifest.entry_count != file_count ||
+			crc_manifest_run(&checked_manifest, 4) != 1)
+		{
+			printf("manifest check failed, read back\n");
+			result = -1;
+		}
+
+		for (entry_index = 0; entry_index < checked_manifest.entry_count && result == 1; entry_index++)
+		{
+			file_index = (size_t)atoi(strrchr(checked_manifest.entries[entry_index].path, '/') + 2);
+			if ((checked_manifest.entries[entry_index].error != 0) != (file_index == 5) ||
+				(file_index != 5 && (checked_manifest.entries[entry_index].calculated_crc == checked_manifest.entries[entry_index].expected_crc) == (file_index == 12)))
+			{
+				printf("manifest check failed, %s read back\n", checked_manifest.entries[entry_index].path);
+				result = -1;
+			}
+		}
+		crc_manifest_free(&checked_manifest);
+	}
+	else if (list_file == NULL)
+	{
+		result = -1;
+	}
+	if (list_file != NULL)
+	{
+		fclose(list_file);
+	}
+
+	// clean up, whatever happened: the files by the names they were written under, then the directories, deepest first.
+	unlink(link_path);
+	for (file_index = 0; file_index < file_count; file_index++)
+	{
+		snprintf(path, sizeof(path), "%s%s/f%02u", root_path, dir_names[file_index % 4], (unsigned)file_index);
+		unlink(path);
+	}
+	for (file_index = sizeof(dir_names) / sizeof(dir_names[0]); file_index-- > 1;)
+	{
+		snprintf(path, sizeof(path), "%s%s", root_path, dir_names[file_index]);
+		rmdir(path);
+	}
+	rmdir(root_path);
+	crc_manifest_free(&manifest);
+	free(file_data);
+
+	return result;
 }
-#endif // #ifdef USE_TABLE_FOR_CRC_32
+#endif // USE_MANIFEST
+///////////////////////////////////////////////////////////////////		MANIFEST FUNCTIONS --	///////////////////////////////////////////////////////////////////
 
 
-uint32_t calculate_crc32(	uint8_t* byte_data,
-							int32_t data_len,
-							uint32_t crc_config_initial_value,
-							uint32_t crc_config_final_xor_value,
-							uint32_t crc_config_polynomial,
-							uint8_t crc_config_reflect_input,
-							uint8_t crc_config_reflect_output )
+
+///////////////////////////////////////////////////////////////////		CLI FUNCTIONS ++	///////////////////////////////////////////////////////////////////
+// the fallback: the whole descriptor through crc_update() in CRC_CLI_READ_BLOCK reads, into a page aligned buffer.
+static int crc_fd_read(crc_model_t* model, int fd, crc_value_t* calculated_crc)
 {
-	int32_t byte_data_index, bit_index;
+	uint8_t* read_memory = malloc(CRC_CLI_READ_BLOCK + CRC_CLI_READ_ALIGN - 1);
+	uint8_t* read_buffer;
+	crc_context_t context;
+	ssize_t read_len;
 
-	uint32_t calculated_crc = crc_config_initial_value;
+	if (read_memory == NULL)
+	{
+		errno = ENOMEM;
+		return -1;
+	}
+	read_buffer = (uint8_t*)(((uintptr_t)read_memory + CRC_CLI_READ_ALIGN - 1) & ~(uintptr_t)(CRC_CLI_READ_ALIGN - 1));
 
-	for(byte_data_index = 0; byte_data_index < data_len; byte_data_index++) // for each byte of data:
+	crc_init(&context, model);
+	while ((read_len = read(fd, read_buffer, CRC_CLI_READ_BLOCK)) != 0)
 	{
-		// xor in the next input byte, **at the MSB**
-		if(crc_config_reflect_input == 1)
-		{
-			//			printf("data: 0x%02X, reflected: 0x%02X\n",byte_data[byte_data_index], reflect(byte_data[byte_data_index],8));
-			calculated_crc ^= reflect(byte_data[byte_data_index],8) << (CRC_WIDTH_32-8);
-		}
-		else
+		if (read_len < 0)
 		{
-			calculated_crc ^= byte_data[byte_data_index] << (CRC_WIDTH_32-8);
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			free(read_memory);
+			return -1;
 		}
+		crc_update(&context, read_buffer, (size_t)read_len);
+	}
 
-#ifdef USE_TABLE_FOR_CRC_32
+	*calculated_crc = crc_final(&context);
+	free(read_memory);
 
-		// http://www.sunshine2k.de/articles/coding/crc/understanding_crc.html
-		// (1)The important point is here that after xoring the current byte into the MSB of the intermediate CRC,
-		// the MSB is the index into the lookup table, so take ONLY MSB for lookup table index... this explains the crc_value >> (WIDTH-8)
-		// used for the lookup table.
-		// (2) now, as we are getting the value corresponding to MSB from the lookup table, drop the MSB from the crc
-		// i.e. shift the crc left, dropping the msb, then XOR this crc/remainder with the lookuptable value.
-		calculated_crc = (calculated_crc << 8) ^ (crc32_table[calculated_crc >> (CRC_WIDTH_32-8) ]);
+	return 0;
+}
 
-#else
 
+// crc of one file ("-" is stdin). a non-empty regular file is mapped and goes through crc_calculate_parallel(), which spreads
+// big files over the cpus and leaves small ones on this thread, a sparse one is read around its holes (see
+// crc_manifest_read_range()). returns -1 with errno set if the file can't be read.
+int crc_file(crc_model_t* model, const char* path, crc_value_t* calculated_crc)
+{
+	struct stat file_stat;
+	int fd, result;
 
-		// calculate crc by iterating over each bit of current byte and applying polynomial.
-		for (bit_index = 0; bit_index < 8; bit_index++)
+	if (strcmp(path, "-") == 0)
+	{
+		return crc_fd_read(model, 0, calculated_crc);
+	}
+
+	fd = open(path, O_RDONLY | O_BINARY);
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+#ifdef USE_MMAP_FOR_CLI
+	if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0 && (uint64_t)file_stat.st_size <= SIZE_MAX)
+	{
+#if defined(USE_MANIFEST) && defined(SEEK_HOLE)
+		// a sparse file has its holes skipped instead of mapped and hashed. fewer blocks than the size needs is only a hint,
+		// compressed and inline data files look the same, so a hole before the end is what tells. mmap doesn't mind the
+		// file offset lseek() leaves behind.
+		off_t first_hole = ((uint64_t)file_stat.st_blocks * 512 < (uint64_t)file_stat.st_size) ? lseek(fd, 0, SEEK_HOLE) : -1;
+
+		if (first_hole >= 0 && first_hole < file_stat.st_size)
 		{
-			// if the MSbit is 1, left-shift and apply the polynomial, else just left-shift
-			if ((calculated_crc & TOPBIT(CRC_WIDTH_32)) != 0)
-			{
-				calculated_crc = ( ( (calculated_crc << 1) ^ crc_config_polynomial ) & CRC_MASK(CRC_WIDTH_32) );
-			}
-			else
+			uint8_t* read_memory = malloc(CRC_CLI_READ_BLOCK + CRC_CLI_READ_ALIGN - 1);
+
+			if (read_memory == NULL)
 			{
-				calculated_crc <<= 1;
+				close(fd);
+				errno = ENOMEM;
+				return -1;
 			}
+
+			result = crc_manifest_read_range(model, fd, 0, (uint64_t)file_stat.st_size,
+						(uint8_t*)(((uintptr_t)read_memory + CRC_CLI_READ_ALIGN - 1) & ~(uintptr_t)(CRC_CLI_READ_ALIGN - 1)), calculated_crc);
+			free(read_memory);
+			close(fd);
+			return result;
 		}
+#endif // USE_MANIFEST && SEEK_HOLE
 
+		void* file_map = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
 
-#endif // USE_TABLE_FOR_CRC_32
+		if (file_map != MAP_FAILED)
+		{
+			// read-ahead as far as it goes, and huge pages where the page cache has them.
+			madvise(file_map, (size_t)file_stat.st_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+			madvise(file_map, (size_t)file_stat.st_size, MADV_HUGEPAGE);
+#endif // MADV_HUGEPAGE
 
+			*calculated_crc = crc_calculate_parallel(model, file_map, (size_t)file_stat.st_size, 0, 0);
 
-		// at this point, we have the calculated crc upto the current byte.
+			munmap(file_map, (size_t)file_stat.st_size);
+			close(fd);
+			return 0;
+		}
 	}
+#else
+	(void)file_stat;
+#endif // USE_MMAP_FOR_CLI
 
-	// xor with final_xor_value:
-	if(crc_config_reflect_output == 1)
+	result = crc_fd_read(model, fd, calculated_crc);
+	close(fd);
+
+	return result;
+}
+
+
+#ifdef USE_MANIFEST
+// a file with holes at the start, in the middle and at the end, and zero pages written out inside its data: crc_file()
+// and crc_manifest_read_range() over ranges that start and end in holes and in data, against crc_calculate() of the
+// file as it reads back in full, and crc_update_zeros() against crc_update() of real zeros.
+int check_crc_sparse()
+{
+	// {offset, length} of the data written, everything else is hole up to file_len.
+	static const uint64_t data_extents [][2] = {{1 << 20, 10000}, {(1 << 20) + 64 * 1024, 300000}, {(3 << 20) + 4096, 777}};
+	static const uint64_t ranges [][2] = {{0, 0}, {0, 100}, {100, 2 << 20}, {(1 << 20) + 5000, 600000}, {(1 << 20) + 70000, CRC_MANIFEST_LEN_UNKNOWN},
+										{(3 << 20) + 4000, 900}, {(4 << 20) - 10, 10}};
+	char path [] = "/tmp/crickey-sparse-XXXXXX";
+	uint64_t file_len = 4 << 20, data_len;
+	uint8_t* file_data;
+	uint8_t* read_memory;
+	crc_model_t* model = crc_find_model("CRC-64/XZ");
+	crc_value_t calculated_crc;
+	crc_context_t context;
+	uint32_t random_state = 0x7F4A7C15;
+	size_t extent_index, range_index;
+	int fd, result = 1;
+
+	file_data = calloc(file_len, 1);
+	read_memory = malloc(CRC_CLI_READ_BLOCK);
+	fd = mkstemp(path);
+	if (file_data == NULL || read_memory == NULL || fd < 0)
 	{
-		calculated_crc =  (reflect(calculated_crc,CRC_WIDTH_32) & CRC_MASK(CRC_WIDTH_32)) ^ crc_config_final_xor_value;
+		printf("sparse check: no temp file\n");
+		free(file_data);
+		free(read_memory);
+		return -1;
 	}
-	else
+
+	for (extent_index = 0; extent_index < sizeof(data_extents) / sizeof(data_extents[0]); extent_index++)
 	{
-		calculated_crc ^= crc_config_final_xor_value;
+		random_state = fill_crc_test_data(file_data + data_extents[extent_index][0], data_extents[extent_index][1], random_state);
 	}
 
-//	printf("calculated_crc_32 = 0x%04X\n",calculated_crc);
+	// zero pages in the middle of the second extent, one of them not page aligned in the reads.
+	memset(file_data + (1 << 20) + 64 * 1024 + 8192, 0, 3 * 4096);
+	memset(file_data + (1 << 20) + 64 * 1024 + 100000 + 17, 0, 2 * 4096);
 
-	return calculated_crc;
+	for (extent_index = 0; extent_index < sizeof(data_extents) / sizeof(data_extents[0]) && result == 1; extent_index++)
+	{
+		if (pwrite(fd, file_data + data_extents[extent_index][0], data_extents[extent_index][1], (off_t)data_extents[extent_index][0]) !=
+			(ssize_t)data_extents[extent_index][1])
+		{
+			printf("sparse check: can't write the temp file\n");
+			result = -1;
+		}
+	}
+	if (result == 1 && ftruncate(fd, (off_t)file_len) != 0)
+	{
+		printf("sparse check: can't write the temp file\n");
+		result = -1;
+	}
+
+	if (result == 1 && (crc_file(model, path, &calculated_crc) != 0 || calculated_crc != crc_calculate(model, file_data, file_len)))
+	{
+		printf("sparse check failed, whole file\n");
+		result = -1;
+	}
+
+	for (range_index = 0; range_index < sizeof(ranges) / sizeof(ranges[0]) && result == 1; range_index++)
+	{
+		data_len = (ranges[range_index][1] == CRC_MANIFEST_LEN_UNKNOWN) ? file_len - ranges[range_index][0] : ranges[range_index][1];
+		if (crc_manifest_read_range(model, fd, ranges[range_index][0], ranges[range_index][1], read_memory, &calculated_crc) != 0 ||
+			calculated_crc != crc_calculate(model, file_data + ranges[range_index][0], data_len))
+		{
+			printf("sparse check failed, %llu bytes from %llu\n", (unsigned long long)data_len, (unsigned long long)ranges[range_index][0]);
+			result = -1;
+		}
+	}
+
+	// the last extent and the hole after it, then data again.
+	crc_init(&context, model);
+	crc_update(&context, file_data + (3 << 20) + 4096, 777);
+	crc_update_zeros(&context, 123457);
+	crc_update(&context, file_data + (1 << 20), 5000);
+	if (result == 1 && (crc_final(&context) != crc_combine(model, crc_calculate(model, file_data + (3 << 20) + 4096, 777 + 123457),
+															crc_calculate(model, file_data + (1 << 20), 5000), 5000) ||
+		context.data_len != 777 + 123457 + 5000))
+	{
+		printf("sparse check failed, zero run\n");
+		result = -1;
+	}
+
+	close(fd);
+	unlink(path);
+	free(file_data);
+	free(read_memory);
+
+	return result;
 }
+#endif // USE_MANIFEST
 
 
-int check_crc_32_algo()
+// sha256sum style: the crc in (width / 4) hex digits, two spaces, the name.
+static void print_crc_line(const crc_model_t* model, crc_value_t calculated_crc, const char* path)
 {
-	// simple 1
-	// CRC-32/BZIP2 : width=32 poly=0x04c11db7 init=0xffffffff refin=false refout=false xorout=0xffffffff check=0xfc891918 name="CRC-32/BZIP2"
-#ifdef USE_TABLE_FOR_CRC_32
-	generate_crc32_table(0x04C11DB7); // required if testing table based implementation.
-#endif // USE_TABLE_FOR_CRC_8
-	if( 0xFC891918 != calculate_crc32((uint8_t*)"123456789",9,0xFFFFFFFF,0xFFFFFFFF,0x04C11DB7,0,0) )
+	printf("%0*llx  %s\n", model->width / 4, (unsigned long long)calculated_crc, path);
+}
+
+
+#ifdef USE_MANIFEST
+// -c: every "<crc>  <name>" line of the list is checked, "<name>: OK" or "<name>: FAILED" per line like sha256sum -c,
+// in list order. the files are read on thread_count threads, see crc_manifest_run().
+// returns the number of files that failed or couldn't be read, -1 if the list itself can't be read.
+static int crc_cli_check(crc_model_t* model, const char* list_path, uint8_t thread_count)
+{
+	FILE* list_file = (strcmp(list_path, "-") == 0) ? stdin : fopen(list_path, "r");
+	crc_manifest_t manifest;
+	crc_manifest_entry_t* entry;
+	size_t entry_index;
+	int failed = 0, unreadable = 0, malformed;
+
+	if (list_file == NULL)
 	{
-		printf ("CRC-32/BZIP2 reference check failed!\n\n");
+		fprintf(stderr, "crickey: %s: %s\n", list_path, strerror(errno));
 		return -1;
 	}
-	else
+
+	crc_manifest_init(&manifest, model);
+	malformed = crc_manifest_read(&manifest, list_file);
+
+	if (list_file != stdin)
 	{
-//		printf ("CRC-32/BZIP2 check passed.\n\n");
+		fclose(list_file);
 	}
 
+	if (malformed < 0 || crc_manifest_run(&manifest, thread_count) < 0)
+	{
+		fprintf(stderr, "crickey: %s: %s\n", list_path, strerror(ENOMEM));
+		crc_manifest_free(&manifest);
+		return -1;
+	}
 
+	for (entry_index = 0; entry_index < manifest.entry_count; entry_index++)
+	{
+		entry = &manifest.entries[entry_index];
 
-	// reflect input data and output crc
-	// CRC-32 : width=32 poly=0x04c11db7 init=0xffffffff refin=true refout=true xorout=0xffffffff check=0xcbf43926 name="CRC-32"
-#ifdef USE_TABLE_FOR_CRC_32
-	generate_crc32_table(0x04C11DB7); // required if testing table based implementation.
-#endif // USE_TABLE_FOR_CRC_8
-	if( 0xCBF43926 != calculate_crc32((uint8_t*)"123456789",9,0xFFFFFFFF,0xFFFFFFFF,0x04C11DB7,1,1) )
+		if (entry->error != 0)
+		{
+			fprintf(stderr, "crickey: %s: %s\n", entry->path, strerror(entry->error));
+			printf("%s: FAILED open or read\n", entry->path);
+			unreadable++;
+		}
+		else if (entry->calculated_crc == entry->expected_crc)
+		{
+			printf("%s: OK\n", entry->path);
+		}
+		else
+		{
+			printf("%s: FAILED\n", entry->path);
+			failed++;
+		}
+	}
+
+	crc_manifest_free(&manifest);
+
+	if (malformed != 0)
 	{
-		printf ("CRC-32 reference check failed!\n\n");
-		return -1;
+		fprintf(stderr, "crickey: WARNING: %d line%s improperly formatted\n", malformed, (malformed == 1) ? " is" : "s are");
 	}
-	else
+	if (unreadable != 0)
 	{
-//		printf ("CRC-32 check passed.\n\n");
+		fprintf(stderr, "crickey: WARNING: %d listed file%s could not be read\n", unreadable, (unreadable == 1) ? "" : "s");
+	}
+	if (failed != 0)
+	{
+		fprintf(stderr, "crickey: WARNING: %d computed checksum%s did NOT match\n", failed, (failed == 1) ? "" : "s");
 	}
 
+	return failed + unreadable;
+}
 
 
-	// reflect input data and output crc - 2
-	// CRC-32C : width=32 poly=0x1edc6f41 init=0xffffffff refin=true refout=true xorout=0xffffffff check=0xe3069283 name="CRC-32C"
-#ifdef USE_TABLE_FOR_CRC_32
-	generate_crc32_table(0x1EDC6f41); // required if testing table based implementation.
-#endif // USE_TABLE_FOR_CRC_8
-	if( 0xE3069283 != calculate_crc32((uint8_t*)"123456789",9,0xFFFFFFFF,0xFFFFFFFF,0x1EDC6f41,1,1) )
+// -r: the manifest of every regular file under the paths, in argument order, each tree sorted. returns the number of
+// files and directories that couldn't be read, -1 if memory ran out.
+static int crc_cli_manifest(crc_model_t* model, char* paths [], int path_count, uint8_t thread_count)
+{
+	crc_manifest_t manifest;
+	size_t entry_index;
+	int path_index, result = 0, unreadable = 0;
+
+	crc_manifest_init(&manifest, model);
+
+	for (path_index = 0; path_index < path_count; path_index++)
 	{
-		printf ("CRC-32C reference check failed!\n\n");
+		result = crc_manifest_walk(&manifest, paths[path_index]);
+		if (result < 0)
+		{
+			break;
+		}
+		unreadable += result;
+	}
+
+	if (result < 0 || crc_manifest_run(&manifest, thread_count) < 0)
+	{
+		fprintf(stderr, "crickey: %s\n", strerror(ENOMEM));
+		crc_manifest_free(&manifest);
 		return -1;
 	}
-	else
+
+	crc_manifest_write(&manifest, stdout);
+
+	for (entry_index = 0; entry_index < manifest.entry_count; entry_index++)
 	{
-//		printf ("CRC-32C check passed.\n\n");
+		if (manifest.entries[entry_index].error != 0)
+		{
+			fprintf(stderr, "crickey: %s: %s\n", manifest.entries[entry_index].path, strerror(manifest.entries[entry_index].error));
+			unreadable++;
+		}
 	}
 
+	crc_manifest_free(&manifest);
+
+	return unreadable;
+}
+#endif // USE_MANIFEST
 
 
-	return 1; // ok.
+static void print_crc_cli_usage()
+{
+	size_t model_index;
+
+	printf("usage: crickey [-m MODEL] [FILE]...\n");
+#ifdef USE_MANIFEST
+	printf("       crickey [-m MODEL] [-j THREADS] -c [LIST]...\n");
+	printf("       crickey [-m MODEL] [-j THREADS] -r [DIR]...\n");
+#endif // USE_MANIFEST
+	printf("       crickey               (no arguments: self-check)\n\n");
+	printf("  -m MODEL   catalogue model, default %s\n", CRC_CLI_DEFAULT_MODEL);
+#ifdef USE_MANIFEST
+	printf("  -c         check the crcs listed in LIST (as printed by crickey), - or none is stdin\n");
+	printf("  -r         manifest of every file under DIR (default .), to check later with -c\n");
+	printf("  -j THREADS threads reading files for -c and -r, default %d per cpu\n", CRC_MANIFEST_THREADS_PER_CPU);
+#endif // USE_MANIFEST
+	printf("  -l         list the catalogue models\n");
+#ifdef USE_ENGINE_TUNING
+	printf("  -t FILE    engine tuning from FILE, made there first if it's missing or from another cpu\n");
+#endif // USE_ENGINE_TUNING
+	printf("  -h         this\n\n");
+	printf("FILE - reads standard input, so does no FILE after an option (crickey -m CRC-32C < file).\n\n");
+	printf("models:");
+	for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+	{
+		printf(" %s", crc_catalogue[model_index].name);
+	}
+	printf("\n");
 }
-///////////////////////////////////////////////////////////////////		CRC32 FUNCTIONS --	///////////////////////////////////////////////////////////////////
+
+
+// the checksum tool: crickey [-m MODEL] [-j THREADS] [-c | -r] [file...]. exit status 0 if every file was read (and matched, for -c).
+int crc_cli_main(int argc, char* argv[])
+{
+	const char* model_name = CRC_CLI_DEFAULT_MODEL;
+	const char* tune_path = NULL;
+	crc_model_t* model;
+	crc_value_t calculated_crc;
+	char* default_paths [1];
+	char** paths;
+	size_t model_index;
+	int option, check_mode = 0, manifest_mode = 0, failures = 0, check_failures, thread_option, path_count, path_index;
+	uint8_t thread_count = 0;
+
+	while ((option = getopt(argc, argv, "m:clht:rj:")) != -1)
+	{
+		switch (option)
+		{
+			case 'm':	model_name = optarg;	break;
+#ifdef USE_MANIFEST
+			case 'c':	check_mode = 1;			break;
+			case 'r':	manifest_mode = 1;		break;
+			case 'j':
+				thread_option = atoi(optarg);
+				thread_count = (thread_option < 1) ? 1 : (thread_option > CRC_PARALLEL_MAX_THREADS) ? CRC_PARALLEL_MAX_THREADS : (uint8_t)thread_option;
+				break;
+#endif // USE_MANIFEST
+			case 't':	tune_path = optarg;		break;
+			case 'l':
+				for (model_index = 0; model_index < CRC_CATALOGUE_SIZE; model_index++)
+				{
+					printf("%s\n", crc_catalogue[model_index].name);
+				}
+				return EXIT_SUCCESS;
+			case 'h':
+				print_crc_cli_usage();
+				return EXIT_SUCCESS;
+			default:
+				print_crc_cli_usage();
+				return EXIT_FAILURE;
+		}
+	}
+
+	if (check_mode && manifest_mode)
+	{
+		fprintf(stderr, "crickey: -c and -r don't go together\n");
+		print_crc_cli_usage();
+		return EXIT_FAILURE;
+	}
+
+	model = crc_find_model(model_name);
+	if (model == NULL)
+	{
+		fprintf(stderr, "crickey: unknown model '%s', -l lists them\n", model_name);
+		return EXIT_FAILURE;
+	}
+
+#ifdef USE_ENGINE_TUNING
+	// a failed tuning still leaves good engines (a disagreeing one is left out), so it's a warning.
+	if (tune_path != NULL && crc_tune(tune_path) != 1)
+	{
+		fprintf(stderr, "crickey: tuning %s: an engine disagreed or the file couldn't be written\n", tune_path);
+	}
+#else
+	(void)tune_path;
+#endif // USE_ENGINE_TUNING
+
+	paths = argv + optind;
+	path_count = argc - optind;
+	if (path_count == 0)
+	{
+		default_paths[0] = manifest_mode ? "." : "-"; // no files: stdin, or the current directory for -r.
+		paths = default_paths;
+		path_count = 1;
+	}
+
+#ifdef USE_MANIFEST
+	if (manifest_mode)
+	{
+		return (crc_cli_manifest(model, paths, path_count, thread_count) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+#else
+	(void)check_mode;
+	(void)check_failures;
+	(void)thread_option;
+	(void)thread_count;
+#endif // USE_MANIFEST
+
+	for (path_index = 0; path_index < path_count; path_index++)
+	{
+#ifdef USE_MANIFEST
+		if (check_mode)
+		{
+			check_failures = crc_cli_check(model, paths[path_index], thread_count);
+			failures += (check_failures != 0);
+		}
+		else
+#endif // USE_MANIFEST
+		if (crc_file(model, paths[path_index], &calculated_crc) == 0)
+		{
+			print_crc_line(model, calculated_crc, paths[path_index]);
+		}
+		else
+		{
+			fprintf(stderr, "crickey: %s: %s\n", paths[path_index], strerror(errno));
+			failures++;
+		}
+	}
+
+	return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+///////////////////////////////////////////////////////////////////		CLI FUNCTIONS --	///////////////////////////////////////////////////////////////////
 
 
 
 ///////////////////////////////////////////////////////////////////		MAIN ++		///////////////////////////////////////////////////////////////////
-int main(void)
+int main(int argc, char* argv[])
 {
+#ifdef CRICKEY_GENERATE_TABLES
+	// table generator build: crickey_tables.h goes to stdout, nothing else.
+	return (print_crc_const_tables() == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+#endif // CRICKEY_GENERATE_TABLES
+
+#ifdef CRICKEY_BENCHMARK
+	// benchmark build: results go to stdout, see BENCHMARK DEFINES.
+	return (run_crc_benchmark() == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+#endif // CRICKEY_BENCHMARK
+
+	// with arguments it's the checksum tool, without it's the self-check below.
+	if (argc > 1)
+	{
+		return crc_cli_main(argc, argv);
+	}
+
 	puts("crickey!"); // prints crickey!
 
 
@@ -685,6 +8876,111 @@ int main(void)
 		printf("\n\nCRC-32 looks good.\n");
 	}
 
+	if( check_crc_64_algo() == 1)
+	{
+		printf("\n\nCRC-64 looks good.\n");
+	}
+
+	if( check_crc_models() == 1)
+	{
+		printf("\n\nCRC models look good.\n");
+	}
+
+#ifdef USE_NIBBLE_TABLES
+	if( check_crc_nibble() == 1)
+	{
+		printf("\n\nCRC nibble engine looks good.\n");
+	}
+#endif // USE_NIBBLE_TABLES
+
+	if( check_crc_streaming() == 1)
+	{
+		printf("\n\nCRC streaming looks good.\n");
+	}
+
+	if( check_crc_iov() == 1)
+	{
+		printf("\n\nCRC scatter-gather looks good.\n");
+	}
+
+	if( check_crc_copy() == 1)
+	{
+		printf("\n\nCRC fused copy looks good.\n");
+	}
+
+	if( check_crc_combine() == 1)
+	{
+		printf("\n\nCRC combine looks good.\n");
+	}
+
+	if( check_crc_patch() == 1)
+	{
+		printf("\n\nCRC patch looks good.\n");
+	}
+
+	if( check_crc_parallel() == 1)
+	{
+		printf("\n\nCRC parallel looks good.\n");
+	}
+
+	if( check_crc_batch() == 1)
+	{
+		printf("\n\nCRC batch looks good.\n");
+	}
+
+	if( check_crc_blocks() == 1)
+	{
+		printf("\n\nCRC block vectors look good.\n");
+	}
+
+	if( check_crc_verify_frames() == 1)
+	{
+		printf("\n\nCRC frame verification looks good.\n");
+	}
+
+#ifdef USE_SPECIALIZED_MODELS
+	if( check_crc_specialized() == 1)
+	{
+		printf("\n\nCRC specialized models look good.\n");
+	}
+#endif // USE_SPECIALIZED_MODELS
+
+	if( check_crc_correct() == 1)
+	{
+		printf("\n\nCRC error correction looks good.\n");
+	}
+
+	if( check_crc_rolling() == 1)
+	{
+		printf("\n\nCRC rolling window looks good.\n");
+	}
+
+#ifdef USE_MANIFEST
+	if( check_crc_manifest() == 1)
+	{
+		printf("\n\nCRC manifest looks good.\n");
+	}
+
+	if( check_crc_sparse() == 1)
+	{
+		printf("\n\nCRC sparse files look good.\n");
+	}
+#endif // USE_MANIFEST
+
+#ifdef USE_ENGINE_TUNING
+	if( check_crc_tuning() == 1)
+	{
+		printf("\n\nCRC engine tuning looks good.\n");
+	}
+#endif // USE_ENGINE_TUNING
+
+#if defined(USE_CONST_TABLES) && !defined(CRICKEY_GENERATE_TABLES)
+	if( check_crc_const_tables() == 1)
+	{
+		printf("\n\nCRC const tables look good.\n");
+	}
+#endif // USE_CONST_TABLES
+
 
 //	generate_crc8_table(0x1D);
 //	print_crc8_table();
@@ -695,6 +8991,9 @@ int main(void)
 //	generate_crc32_table(0x1189);
 //	print_crc32_table();
 
+//	generate_crc64_table(0x42F0E1EBA9EA3693);
+//	print_crc64_table();
+
 
 
 	return EXIT_SUCCESS;